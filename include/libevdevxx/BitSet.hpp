@@ -0,0 +1,424 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_BIT_SET_HPP
+#define LIBEVDEVXX_BIT_SET_HPP
+
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+
+
+namespace evdev {
+
+    /**
+     * @brief A fixed-size bit set, with the same layout as the kernel's bitmaps.
+     *
+     * The bits are stored in `unsigned long` words, like the `EVIOCGBIT` ioctls
+     * expect, so data() can be passed to them directly. Iterating yields the indices of
+     * the set bits, skipping whole words of zeros, and using `std::countr_zero()` within
+     * a word.
+     */
+    template<std::size_t N>
+    class BitSet {
+
+    public:
+
+        using word_type = unsigned long;
+
+        static constexpr std::size_t word_bits = sizeof(word_type) * CHAR_BIT;
+        static constexpr std::size_t num_words = (N + word_bits - 1) / word_bits;
+
+    private:
+
+        std::array<word_type, num_words> words{};
+
+    public:
+
+        /// Forward iterator over the indices of the set bits.
+        class Iterator {
+
+            const word_type* words = nullptr;
+            std::size_t index = num_words;
+            word_type bits = 0; // the bits of words[index] not visited yet
+
+            constexpr
+            void
+            skip_zeros()
+                noexcept
+            {
+                while (!bits && ++index < num_words)
+                    bits = words[index];
+            }
+
+        public:
+
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = std::size_t;
+
+
+            constexpr
+            Iterator()
+                noexcept = default;
+
+            constexpr
+            Iterator(const word_type* w,
+                     std::size_t i)
+                noexcept :
+                words{w},
+                index{i},
+                bits{i < num_words ? w[i] : 0}
+            {
+                if (index < num_words)
+                    skip_zeros();
+            }
+
+
+            constexpr
+            std::size_t
+            operator *()
+                const noexcept
+            {
+                return index * word_bits + std::countr_zero(bits);
+            }
+
+
+            constexpr
+            Iterator&
+            operator ++()
+                noexcept
+            {
+                bits &= bits - 1; // clear the lowest set bit
+                skip_zeros();
+                return *this;
+            }
+
+            constexpr
+            Iterator
+            operator ++(int)
+                noexcept
+            {
+                Iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+
+            constexpr
+            bool
+            operator ==(const Iterator& other)
+                const noexcept
+            {
+                return index == other.index && bits == other.bits;
+            }
+
+        }; // class Iterator
+
+
+        constexpr
+        BitSet()
+            noexcept = default;
+
+
+        [[nodiscard]]
+        static
+        constexpr
+        std::size_t
+        size()
+            noexcept
+        {
+            return N;
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        bool
+        test(std::size_t i)
+            const noexcept
+        {
+            return i < N && (words[i / word_bits] >> (i % word_bits)) & 1;
+        }
+
+
+        constexpr
+        void
+        set(std::size_t i,
+            bool value = true)
+            noexcept
+        {
+            if (i >= N)
+                return;
+            const word_type mask = word_type{1} << (i % word_bits);
+            if (value)
+                words[i / word_bits] |= mask;
+            else
+                words[i / word_bits] &= ~mask;
+        }
+
+
+        constexpr
+        void
+        reset(std::size_t i)
+            noexcept
+        {
+            set(i, false);
+        }
+
+
+        /// Clear all bits.
+        constexpr
+        void
+        clear()
+            noexcept
+        {
+            words = {};
+        }
+
+
+        /// How many bits are set.
+        [[nodiscard]]
+        constexpr
+        std::size_t
+        count()
+            const noexcept
+        {
+            std::size_t result = 0;
+            for (word_type w : words)
+                result += std::popcount(w);
+            return result;
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        bool
+        any()
+            const noexcept
+        {
+            for (word_type w : words)
+                if (w)
+                    return true;
+            return false;
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        bool
+        none()
+            const noexcept
+        {
+            return !any();
+        }
+
+
+        /// Check if every bit set in `other` is also set here.
+        [[nodiscard]]
+        constexpr
+        bool
+        is_superset(const BitSet& other)
+            const noexcept
+        {
+            for (std::size_t i = 0; i < num_words; ++i)
+                if (other.words[i] & ~words[i])
+                    return false;
+            return true;
+        }
+
+
+        /// Check if every bit set here is also set in `other`.
+        [[nodiscard]]
+        constexpr
+        bool
+        is_subset(const BitSet& other)
+            const noexcept
+        {
+            return other.is_superset(*this);
+        }
+
+
+        /// Check if any bit is set in both.
+        [[nodiscard]]
+        constexpr
+        bool
+        intersects(const BitSet& other)
+            const noexcept
+        {
+            for (std::size_t i = 0; i < num_words; ++i)
+                if (words[i] & other.words[i])
+                    return true;
+            return false;
+        }
+
+
+        constexpr
+        BitSet&
+        operator &=(const BitSet& other)
+            noexcept
+        {
+            for (std::size_t i = 0; i < num_words; ++i)
+                words[i] &= other.words[i];
+            return *this;
+        }
+
+
+        constexpr
+        BitSet&
+        operator |=(const BitSet& other)
+            noexcept
+        {
+            for (std::size_t i = 0; i < num_words; ++i)
+                words[i] |= other.words[i];
+            return *this;
+        }
+
+
+        constexpr
+        BitSet&
+        operator ^=(const BitSet& other)
+            noexcept
+        {
+            for (std::size_t i = 0; i < num_words; ++i)
+                words[i] ^= other.words[i];
+            return *this;
+        }
+
+
+        [[nodiscard]]
+        friend
+        constexpr
+        BitSet
+        operator &(BitSet a,
+                   const BitSet& b)
+            noexcept
+        {
+            return a &= b;
+        }
+
+
+        [[nodiscard]]
+        friend
+        constexpr
+        BitSet
+        operator |(BitSet a,
+                   const BitSet& b)
+            noexcept
+        {
+            return a |= b;
+        }
+
+
+        [[nodiscard]]
+        friend
+        constexpr
+        BitSet
+        operator ^(BitSet a,
+                   const BitSet& b)
+            noexcept
+        {
+            return a ^= b;
+        }
+
+
+        constexpr
+        bool
+        operator ==(const BitSet& other)
+            const noexcept = default;
+
+
+        [[nodiscard]]
+        constexpr
+        Iterator
+        begin()
+            const noexcept
+        {
+            return Iterator{words.data(), 0};
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        Iterator
+        end()
+            const noexcept
+        {
+            return {};
+        }
+
+
+        /// The raw words, to be filled by an ioctl.
+        [[nodiscard]]
+        constexpr
+        word_type*
+        data()
+            noexcept
+        {
+            return words.data();
+        }
+
+        [[nodiscard]]
+        constexpr
+        const word_type*
+        data()
+            const noexcept
+        {
+            return words.data();
+        }
+
+        /// Size of data(), in bytes.
+        [[nodiscard]]
+        static
+        constexpr
+        std::size_t
+        size_bytes()
+            noexcept
+        {
+            return sizeof(word_type) * num_words;
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        std::size_t
+        hash()
+            const noexcept
+        {
+            // FNV-1a, one word at a time, with the constants for the width of size_t
+            constexpr bool wide = sizeof(std::size_t) >= 8;
+            constexpr std::size_t basis = wide ? std::size_t(0xcbf29ce484222325ull) : 0x811c9dc5;
+            constexpr std::size_t prime = wide ? std::size_t(0x100000001b3ull) : 0x01000193;
+            std::size_t result = basis ^ N;
+            for (word_type w : words)
+                result = (result ^ static_cast<std::size_t>(w)) * prime;
+            return result;
+        }
+
+    }; // class BitSet
+
+} // namespace evdev
+
+
+template<std::size_t N>
+struct std::hash<evdev::BitSet<N>> {
+
+    std::size_t
+    operator ()(const evdev::BitSet<N>& bits)
+        const noexcept
+    {
+        return bits.hash();
+    }
+
+};
+
+#endif
@@ -0,0 +1,27 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_CANCEL_TOKEN_HPP
+#define LIBEVDEVXX_CANCEL_TOKEN_HPP
+
+#include "Doorbell.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief Wakes up readers blocked in Device::read_for(), from any thread.
+     *
+     * Doorbell::ring() cancels all current and future reads using the token, since it
+     * interrupts a `ppoll()` in progress, not just the next read; the token stays
+     * canceled until Doorbell::clear() is called.
+     */
+    using CancelToken = Doorbell;
+
+} // namespace evdev
+
+#endif
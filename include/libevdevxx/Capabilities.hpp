@@ -0,0 +1,221 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_CAPABILITIES_HPP
+#define LIBEVDEVXX_CAPABILITIES_HPP
+
+#include <array>
+#include <cstddef>
+#include <functional>
+
+#include <libevdev/libevdev.h>
+
+#include "AbsInfo.hpp"
+#include "BitSet.hpp"
+#include "Code.hpp"
+#include "Property.hpp"
+#include "Type.hpp"
+#include "TypeCode.hpp"
+
+
+namespace evdev {
+
+    class Device;
+
+
+    /**
+     * @brief A snapshot of what a device can do: types, codes, properties and axes.
+     *
+     * Everything is stored in fixed-size bitmaps and a flat AbsInfo table, so a snapshot
+     * is a single allocation-free object that can be copied, compared and hashed.
+     * Building it from a file descriptor takes one `EVIOCGBIT` ioctl per supported type,
+     * plus one `EVIOCGABS` per axis, instead of one library call per possible code.
+     *
+     * Comparisons and hashing ignore the current axis values (`AbsInfo::val`), so two
+     * snapshots of the same device compare equal.
+     */
+    class Capabilities {
+
+    public:
+
+        /// Bitmap of the codes of a single type; it fits the codes of any type.
+        using CodeSet = BitSet<KEY_CNT>;
+        using TypeSet = BitSet<EV_CNT>;
+        using PropertySet = BitSet<INPUT_PROP_CNT>;
+
+    private:
+
+        TypeSet types;
+        PropertySet props;
+        std::array<CodeSet, EV_CNT> codes;
+        std::array<AbsInfo, ABS_CNT> abs_info;
+
+        // Add the codes that libevdev reports, but the kernel has no bitmap for.
+        void
+        add_implicit_codes()
+            noexcept;
+
+    public:
+
+        /// Create an empty set.
+        Capabilities()
+            noexcept = default;
+
+        /**
+         * @brief Query the kernel, through a `/dev/input/event*` file descriptor.
+         *
+         * @throw std::system_error if an ioctl fails.
+         */
+        explicit
+        Capabilities(int fd);
+
+        /**
+         * @brief Take a snapshot of a Device.
+         *
+         * If the device has a file descriptor, the bitmaps are queried from the kernel,
+         * so changes made only to the libevdev copy (through enable() or disable()) are
+         * not seen. Otherwise, libevdev is queried.
+         *
+         * @throw std::system_error if an ioctl fails.
+         */
+        explicit
+        Capabilities(const Device& dev);
+
+
+        [[nodiscard]]
+        bool
+        has(Type type)
+            const noexcept;
+
+        [[nodiscard]]
+        bool
+        has(Type type,
+            Code code)
+            const noexcept;
+
+        [[nodiscard]]
+        bool
+        has(TypeCode tc)
+            const noexcept;
+
+        [[nodiscard]]
+        bool
+        has(Property prop)
+            const noexcept;
+
+
+        /// Enable a type, without any code.
+        void
+        enable(Type type)
+            noexcept;
+
+        /// Enable a type/code; enables the type too.
+        void
+        enable(Type type,
+               Code code)
+            noexcept;
+
+        /// Enable an axis, with its parameters.
+        void
+        enable_abs(Code code,
+                   const AbsInfo& info)
+            noexcept;
+
+        /// Disable a type/code.
+        void
+        disable(Type type,
+                Code code)
+            noexcept;
+
+        void
+        enable(Property prop)
+            noexcept;
+
+        void
+        disable(Property prop)
+            noexcept;
+
+
+        [[nodiscard]]
+        const TypeSet&
+        get_types()
+            const noexcept;
+
+        [[nodiscard]]
+        const CodeSet&
+        get_codes(Type type)
+            const noexcept;
+
+        [[nodiscard]]
+        const PropertySet&
+        get_properties()
+            const noexcept;
+
+        /// The axis parameters; all zeros if the axis is not supported.
+        [[nodiscard]]
+        const AbsInfo&
+        get_abs_info(Code code)
+            const;
+
+
+        /**
+         * @brief What both have in common.
+         *
+         * The axis parameters are taken from this object.
+         */
+        [[nodiscard]]
+        Capabilities
+        intersect(const Capabilities& other)
+            const noexcept;
+
+        /**
+         * @brief Check if this has everything `other` has.
+         *
+         * Axis parameters are not compared.
+         */
+        [[nodiscard]]
+        bool
+        is_superset(const Capabilities& other)
+            const noexcept;
+
+        /// Check if `other` has everything this has.
+        [[nodiscard]]
+        bool
+        is_subset(const Capabilities& other)
+            const noexcept;
+
+
+        /// Compare everything, except the current axis values.
+        [[nodiscard]]
+        bool
+        operator ==(const Capabilities& other)
+            const noexcept;
+
+
+        [[nodiscard]]
+        std::size_t
+        hash()
+            const noexcept;
+
+    }; // class Capabilities
+
+} // namespace evdev
+
+
+template<>
+struct std::hash<evdev::Capabilities> {
+
+    std::size_t
+    operator ()(const evdev::Capabilities& caps)
+        const noexcept
+    {
+        return caps.hash();
+    }
+
+};
+
+#endif
@@ -0,0 +1,162 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_CAPABILITY_CACHE_HPP
+#define LIBEVDEVXX_CAPABILITY_CACHE_HPP
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "DeviceInfo.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief A persistent cache of DeviceInfo, to skip probing devices on startup.
+     *
+     * Entries are keyed by the device number of the node, plus a hash of its sysfs
+     * identity: the resolved `/sys/dev/char/MAJ:MIN` path, which changes when a device is
+     * unplugged and plugged again, and the device's `modalias`, which encodes its ids and
+     * capabilities. Computing the key only needs a `stat()` and a couple of sysfs reads,
+     * so a hit never opens the node. If the identity changed, the entry is ignored.
+     *
+     * The file is a sorted index followed by compact, variable-sized records; it's
+     * mapped with `mmap()`, and records are only decoded on lookup. save() writes a new
+     * file and renames it over the old one, so readers never see a partial file.
+     *
+     * The file is only meaningful on the machine that wrote it.
+     */
+    class CapabilityCache {
+
+    public:
+
+        /// Identifies a device node.
+        struct Key {
+
+            std::uint64_t dev = 0;   ///< The `dev_t` of the node.
+            std::uint64_t ident = 0; ///< Hash of the sysfs identity.
+
+            constexpr
+            auto
+            operator <=>(const Key&)
+                const noexcept = default;
+
+        };
+
+    private:
+
+        std::filesystem::path file;
+
+        const std::byte* map = nullptr;
+        std::size_t map_size = 0;
+
+        // Entries inserted since the last save(); they replace mapped ones, by `dev`.
+        std::map<std::uint64_t, std::pair<Key, std::vector<std::byte>>> updates;
+
+
+        void
+        unmap()
+            noexcept;
+
+        void
+        remap();
+
+        // The index entries in the mapped file.
+        struct IndexEntry;
+
+        [[nodiscard]]
+        std::span<const IndexEntry>
+        get_index()
+            const noexcept;
+
+    public:
+
+        /**
+         * @brief Open a cache file.
+         *
+         * A missing or invalid file results in an empty cache, not an error.
+         */
+        explicit
+        CapabilityCache(const std::filesystem::path& file);
+
+        ~CapabilityCache()
+            noexcept;
+
+
+        CapabilityCache(const CapabilityCache&) = delete;
+
+        CapabilityCache&
+        operator =(const CapabilityCache&) = delete;
+
+
+        /**
+         * @brief Compute the key of a device node, without opening it.
+         *
+         * @return No value if the node, or its sysfs entry, doesn't exist.
+         */
+        [[nodiscard]]
+        static
+        std::optional<Key>
+        make_key(const std::filesystem::path& node);
+
+
+        /// Look up a device node; the result has `path` set to `node`.
+        [[nodiscard]]
+        std::optional<DeviceInfo>
+        find(const std::filesystem::path& node)
+            const;
+
+        /// Look up a key.
+        [[nodiscard]]
+        std::optional<DeviceInfo>
+        find(const Key& key)
+            const;
+
+
+        /**
+         * @brief Add or replace the entry for a device.
+         *
+         * Failed probes are ignored. The entry is only written by save().
+         *
+         * @return `false` if the device has no key.
+         */
+        bool
+        insert(const DeviceInfo& info);
+
+        /// Same as above, with a key already computed.
+        void
+        insert(const Key& key,
+               const DeviceInfo& info);
+
+
+        /**
+         * @brief Write all entries to the file, atomically.
+         *
+         * @throw std::system_error
+         */
+        void
+        save();
+
+
+        /// How many entries there are, including unsaved ones.
+        [[nodiscard]]
+        std::size_t
+        size()
+            const noexcept;
+
+    }; // class CapabilityCache
+
+} // namespace evdev
+
+#endif
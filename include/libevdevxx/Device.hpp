@@ -9,12 +9,14 @@
 #define LIBEVDEVXX_DEVICE_HPP
 
 #include <cstddef>
+#include <chrono>
 #include <cstdarg>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -26,7 +28,9 @@
 #include "AbsInfo.hpp"
 #include "basic_wrapper.hpp"
 #include "Event.hpp"
+#include "EventFrame.hpp"
 #include "Property.hpp"
+#include "RawEvent.hpp"
 #include "ReadFlag.hpp"
 #include "ReadStatus.hpp"
 #include "TypeCode.hpp"
@@ -35,6 +39,12 @@
 /// The namespace of libevdevxx.
 namespace evdev {
 
+    class Doorbell;
+    class EventAwaiter;
+    class FrameAwaiter;
+    class Resync;
+
+
     /**
      * @brief Represents a device (real or not).
      *
@@ -50,6 +60,44 @@ namespace evdev {
 
         int owned_fd = -1;
 
+        // Copy of the kernel event mask, to filter resync deltas; null if not masked.
+        struct EventMask;
+        std::unique_ptr<EventMask> event_mask;
+
+        [[nodiscard]]
+        bool
+        is_masked(std::uint16_t type,
+                  std::uint16_t code)
+            const noexcept;
+
+        // Events read since the last SYN_REPORT, and how many were pending when the last
+        // SYN_DROPPED was read; see Resync.
+        std::size_t frame_events = 0;
+        std::size_t dropped_frame_events = 0;
+
+        void
+        track_frame(const ::input_event& event)
+            noexcept
+        {
+            if (event.type != EV_SYN)
+                ++frame_events;
+            else if (event.code == SYN_REPORT)
+                frame_events = 0;
+            else if (event.code == SYN_DROPPED) {
+                dropped_frame_events = frame_events;
+                frame_events = 0;
+            }
+        }
+
+        template<typename T>
+        std::size_t
+        read_batch_impl(std::span<T> events,
+                        ReadStatus& status,
+                        ReadFlag flags)
+            noexcept;
+
+        friend class Resync;
+
         using state_type = std::tuple<BaseType::state_type, int>;
 
 
@@ -315,6 +363,71 @@ namespace evdev {
         void
         ungrab();
 
+
+        /**
+         * @brief Only receive the given codes of a type, through `EVIOCSMASK`.
+         *
+         * The filtering is done by the kernel, so masked events don't wake up the reader.
+         * Masks only affect this file descriptor. `EV_SYN` events are never masked.
+         *
+         * The libevdev state of masked codes is not updated anymore, so get_value() on
+         * them returns stale values; the deltas for masked codes are also removed from
+         * resyncs, so they don't show up after a `SYN_DROPPED`.
+         *
+         * @param type The event type; it can't be `EV_SYN`, use set_type_mask() instead.
+         * The kernel only masks the codes of `EV_KEY`, `EV_REL`, `EV_ABS`, `EV_MSC`,
+         * `EV_SW`, `EV_LED`, `EV_SND` and `EV_FF`; other types can only be masked as a
+         * whole, with set_type_mask().
+         *
+         * @param codes The codes to receive; all others of this type are masked.
+         *
+         * @throw std::invalid_argument if the codes of `type` can't be masked.
+         *
+         * @throw std::system_error
+         */
+        void
+        set_event_mask(Type type,
+                       std::span<const Code> codes);
+
+        /// Only receive the given event types; `EV_SYN` is always received.
+        void
+        set_type_mask(std::span<const Type> types);
+
+        /**
+         * @brief Only receive the given type/codes.
+         *
+         * This sets the type mask, and the code mask of every type involved.
+         */
+        void
+        set_event_mask(std::span<const TypeCode> codes);
+
+        /// Receive all events again.
+        void
+        clear_event_mask();
+
+
+        /**
+         * @brief Query the codes of a type that are received, through `EVIOCGMASK`.
+         *
+         * @throw std::invalid_argument if the codes of `type` can't be masked.
+         */
+        [[nodiscard]]
+        std::vector<Code>
+        get_event_mask(Type type)
+            const;
+
+        /// Query the event types that are received.
+        [[nodiscard]]
+        std::vector<Type>
+        get_type_mask()
+            const;
+
+        /// Check if a type/code was masked through this Device.
+        [[nodiscard]]
+        bool
+        is_masked(TypeCode tc)
+            const noexcept;
+
         /**
          * @brief Set a file descriptor and read the device metadata.
          *
@@ -674,15 +787,173 @@ namespace evdev {
         // -------------- //
 
 
+        /**
+         * @brief Read an event.
+         *
+         * @throw SyncError if a `SYN_DROPPED` is read, in normal mode.
+         *
+         * @throw std::system_error on other errors, including `EAGAIN`.
+         */
         Event
         read(ReadFlag flags = ReadFlag::normal);
 
+        /**
+         * @brief Read an event, without throwing.
+         *
+         * A `SYN_DROPPED` is stored in `event`, and `ReadStatus::dropped` is returned;
+         * use resync() to read the deltas.
+         */
         [[nodiscard]]
         ReadStatus
         read(Event& event,
              ReadFlag flags = ReadFlag::normal)
             noexcept;
 
+        /**
+         * @brief Read many events in a single call.
+         *
+         * Events are read until the span is full, or until no more events are
+         * available. The `ReadFlag::blocking` flag only applies to the first event.
+         *
+         * When a `SYN_DROPPED` is found in normal mode, it's stored as the last event,
+         * `status` is set to `ReadStatus::dropped`, and no exception is thrown; the
+         * caller should then read again with `ReadFlag::resync`. In resync mode the
+         * delta events are read until the sync is complete.
+         *
+         * @param events Where to store the events.
+         *
+         * @param[out] status The status of the last read: `ReadStatus::again` if all
+         * events were consumed, `ReadStatus::dropped` if a sync is needed, or a
+         * negative `errno` value on error.
+         *
+         * @param flags Flags to use for reading.
+         *
+         * @return How many events were stored in `events`.
+         */
+        std::size_t
+        read_batch(std::span<Event> events,
+                   ReadStatus& status,
+                   ReadFlag flags = ReadFlag::normal)
+            noexcept;
+
+        /// Same as above, but with `::input_event` storage.
+        std::size_t
+        read_batch(std::span<::input_event> events,
+                   ReadStatus& status,
+                   ReadFlag flags = ReadFlag::normal)
+            noexcept;
+
+        /// Same as above, but with RawEvent storage.
+        std::size_t
+        read_batch(std::span<RawEvent> events,
+                   ReadStatus& status,
+                   ReadFlag flags = ReadFlag::normal)
+            noexcept;
+
+        /**
+         * @brief Read a complete frame of events.
+         *
+         * Events are appended to `frame` until a `SYN_REPORT` is read. If no more events
+         * are available before that, `ReadStatus::again` is returned and the partial
+         * frame is kept, so the next call will continue filling it. A frame that was
+         * complete, or invalid, is cleared before reading.
+         *
+         * If a `SYN_DROPPED` is read in normal mode, the frame is marked as invalid and
+         * `ReadStatus::dropped` is returned, instead of throwing SyncError; the caller
+         * should then read again with `ReadFlag::resync`.
+         *
+         * @return `ReadStatus::success` if the frame is complete.
+         */
+        ReadStatus
+        read_frame(EventFrame& frame,
+                   ReadFlag flags = ReadFlag::normal);
+
+        /**
+         * @brief Read an event, waiting at most `timeout` for it.
+         *
+         * Unlike `ReadFlag::blocking`, the wait happens in `ppoll()`, outside libevdev,
+         * so it can time out. The file descriptor should be in non-blocking mode.
+         *
+         * @return Same as read(Event&, ReadFlag), or `ReadStatus::timeout` if no event
+         * arrived in time.
+         */
+        [[nodiscard]]
+        ReadStatus
+        read_for(Event& event,
+                 std::chrono::nanoseconds timeout,
+                 ReadFlag flags = ReadFlag::normal)
+            noexcept;
+
+        /**
+         * @brief Read an event, waiting at most `timeout`, or until `token` is rung.
+         *
+         * Doorbell::ring() can be called from another thread to wake up the reader
+         * immediately; the token stays rung until Doorbell::clear().
+         *
+         * @return Same as above, or `ReadStatus::canceled` if `token` was rung.
+         */
+        [[nodiscard]]
+        ReadStatus
+        read_for(Event& event,
+                 std::chrono::nanoseconds timeout,
+                 const Doorbell& token,
+                 ReadFlag flags = ReadFlag::normal)
+            noexcept;
+
+        /**
+         * @brief Wait for the next event, from a coroutine.
+         *
+         * `co_await dev.next_event()` behaves like read(), but suspends the calling Task
+         * until the device is readable, instead of failing with `EAGAIN`. It must be
+         * awaited from a Task running on a Scheduler.
+         *
+         * @sa Scheduler
+         */
+        [[nodiscard]]
+        EventAwaiter
+        next_event(ReadFlag flags = ReadFlag::normal)
+            noexcept;
+
+        /**
+         * @brief Wait for the next event, from a coroutine, without throwing.
+         *
+         * Same as above, but the read status is stored in `status`, like
+         * read(Event&, ReadFlag), instead of throwing SyncError or `std::system_error`.
+         */
+        [[nodiscard]]
+        EventAwaiter
+        next_event(ReadStatus& status,
+                   ReadFlag flags = ReadFlag::normal)
+            noexcept;
+
+        /**
+         * @brief Wait for a complete frame, from a coroutine.
+         *
+         * `co_await dev.next_frame(frame)` behaves like read_frame(), but suspends the
+         * calling Task until the frame is complete, or a `SYN_DROPPED` is read.
+         *
+         * @sa Scheduler
+         */
+        [[nodiscard]]
+        FrameAwaiter
+        next_frame(EventFrame& frame,
+                   ReadFlag flags = ReadFlag::normal)
+            noexcept;
+
+        /**
+         * @brief Recover from a `SYN_DROPPED`, without exceptions.
+         *
+         * `for (const Event& delta : dev.resync())` iterates over the delta events
+         * that bring the caller's state up to date with the device. If no sync is
+         * needed, the range is empty.
+         *
+         * @sa Resync
+         */
+        [[nodiscard]]
+        Resync
+        resync()
+            noexcept;
+
         [[nodiscard]]
         bool
         has_pending();
@@ -0,0 +1,93 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_DEVICE_INFO_HPP
+#define LIBEVDEVXX_DEVICE_INFO_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+
+#include "Capabilities.hpp"
+#include "Device.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief What a device is, without keeping it open.
+     *
+     * A DeviceInfo is filled with a handful of ioctls, through a LiteDevice, without
+     * creating a libevdev device; use open() when the device is actually needed.
+     */
+    struct DeviceInfo {
+
+        std::filesystem::path path;
+        std::string name;
+        std::optional<std::string> phys;
+        std::optional<std::string> uniq;
+        std::uint16_t bustype = 0;
+        std::uint16_t vendor = 0;
+        std::uint16_t product = 0;
+        std::uint16_t version = 0;
+        int driver_version = 0;
+        Capabilities caps;
+
+        /// Why probing failed; `ETIMEDOUT` if it took too long.
+        std::error_code error;
+
+
+        /**
+         * @brief Probe a device node.
+         *
+         * Errors are stored in `error`, instead of being thrown.
+         */
+        [[nodiscard]]
+        static
+        DeviceInfo
+        probe(const std::filesystem::path& path);
+
+
+        /**
+         * @brief What identifies a device: the name, `phys`, ids and Capabilities.
+         *
+         * The path, `uniq`, driver version and error are left empty.
+         */
+        [[nodiscard]]
+        DeviceInfo
+        fingerprint()
+            const;
+
+        /// Same as above, from an open device.
+        [[nodiscard]]
+        static
+        DeviceInfo
+        fingerprint(const Device& dev);
+
+
+        /// Check if probing succeeded.
+        [[nodiscard]]
+        explicit
+        operator bool()
+            const noexcept;
+
+
+        /// Open the device.
+        [[nodiscard]]
+        Device
+        open(int flags = O_RDONLY | O_NONBLOCK)
+            const;
+
+    }; // struct DeviceInfo
+
+} // namespace evdev
+
+#endif
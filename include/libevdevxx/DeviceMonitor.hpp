@@ -0,0 +1,170 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_DEVICE_MONITOR_HPP
+#define LIBEVDEVXX_DEVICE_MONITOR_HPP
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "DeviceInfo.hpp"
+#include "DeviceScanner.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief Reports input devices as they appear and disappear, through `inotify`.
+     *
+     * This watches the `event*` nodes in `/dev/input`, with no udev dependency. When a
+     * node is created, it's usually owned by root until udev fixes its permissions, so
+     * a probe that fails with `EACCES` or `EPERM` is retried on every `IN_ATTRIB`
+     * change, and periodically, until the settle timeout expires; only then is the
+     * device reported, with its `error` set.
+     *
+     * Probes run on a DeviceScanner, so a driver that hangs can't stall process()
+     * longer than the probe timeout; such a device is reported right away, with
+     * `ETIMEDOUT`.
+     *
+     * The monitor doesn't block and has no thread: watch get_fd() with `epoll` (or
+     * `poll`), and call process() when it's readable. For example:
+     *
+     * @code
+     * DeviceMonitor monitor;
+     * monitor.on_added([](const DeviceInfo& info) { ... });
+     * loop.add(monitor.get_fd(), EPOLLIN,
+     *          [&monitor](int, std::uint32_t) { monitor.process(); });
+     * monitor.add_existing();
+     * @endcode
+     */
+    class DeviceMonitor {
+
+    public:
+
+        /// Called when a device appears; check `info.error` before using it.
+        using AddedHandler = std::function<void(const DeviceInfo& info)>;
+
+        /// Called when a previously added device disappears.
+        using RemovedHandler = std::function<void(const std::filesystem::path& path)>;
+
+    private:
+
+        std::filesystem::path dir;
+        std::chrono::milliseconds retry_interval;
+        std::chrono::milliseconds settle_timeout;
+        DeviceScanner scanner;
+
+        int epoll_fd = -1;
+        int inotify_fd = -1;
+        int timer_fd = -1;
+
+        AddedHandler added;
+        RemovedHandler removed;
+
+        struct Pending {
+            std::chrono::steady_clock::time_point first_seen;
+            std::chrono::steady_clock::time_point next_try;
+        };
+
+        // Keyed by node name.
+        std::map<std::string, Pending> pending;
+        std::set<std::string> present;
+
+
+        void
+        close_all()
+            noexcept;
+
+        void
+        try_add(const std::string& name);
+
+        void
+        try_add(const std::vector<std::string>& names);
+
+        void
+        handle_removal(const std::string& name);
+
+        void
+        rescan();
+
+        void
+        retry_pending();
+
+        void
+        arm_timer();
+
+    public:
+
+        /**
+         * @param dir The directory to watch.
+         *
+         * @param retry_interval How often to retry devices without permission.
+         *
+         * @param settle_timeout How long to wait for the permissions to be fixed.
+         *
+         * @param probe_timeout How long probing a single device may take.
+         *
+         * @throw std::system_error
+         */
+        explicit
+        DeviceMonitor(const std::filesystem::path& dir = "/dev/input",
+                      std::chrono::milliseconds retry_interval = std::chrono::milliseconds{50},
+                      std::chrono::milliseconds settle_timeout = std::chrono::seconds{2},
+                      std::chrono::milliseconds probe_timeout = std::chrono::seconds{1});
+
+        ~DeviceMonitor()
+            noexcept;
+
+
+        DeviceMonitor(const DeviceMonitor&) = delete;
+
+        DeviceMonitor&
+        operator =(const DeviceMonitor&) = delete;
+
+
+        void
+        on_added(AddedHandler handler);
+
+        void
+        on_removed(RemovedHandler handler);
+
+
+        /// Report the devices that already exist, as if they were just added.
+        void
+        add_existing();
+
+        /**
+         * @brief Handle pending notifications, without blocking.
+         *
+         * The handlers are called from here.
+         */
+        void
+        process();
+
+
+        /// A file descriptor that becomes readable when process() should be called.
+        [[nodiscard]]
+        int
+        get_fd()
+            const noexcept;
+
+        /// The devices reported as added, and not removed yet.
+        [[nodiscard]]
+        std::vector<std::filesystem::path>
+        get_devices()
+            const;
+
+    }; // class DeviceMonitor
+
+} // namespace evdev
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_DEVICE_SCANNER_HPP
+#define LIBEVDEVXX_DEVICE_SCANNER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "CapabilityCache.hpp"
+#include "DeviceInfo.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief Probes many device nodes in parallel.
+     *
+     * Each device is probed with DeviceInfo::probe(), on a bounded pool of worker
+     * threads. A device that takes longer than the timeout (because of a hung driver,
+     * for instance) is reported with `ETIMEDOUT`, and its worker is abandoned and
+     * replaced; the scan itself never waits longer than the timeout for any device.
+     */
+    class DeviceScanner {
+
+        std::size_t max_threads;
+        std::chrono::milliseconds timeout;
+
+    public:
+
+        /**
+         * @param max_threads Upper bound on concurrent probes; zero means one per CPU.
+         *
+         * @param timeout How long a single device may take.
+         */
+        explicit
+        DeviceScanner(std::size_t max_threads = 0,
+                      std::chrono::milliseconds timeout = std::chrono::seconds{1})
+            noexcept;
+
+
+        /// List the `event*` nodes in `dir`, in numerical order.
+        [[nodiscard]]
+        static
+        std::vector<std::filesystem::path>
+        list(const std::filesystem::path& dir = "/dev/input");
+
+
+        /// Probe all `event*` nodes in `/dev/input`.
+        [[nodiscard]]
+        std::vector<DeviceInfo>
+        scan()
+            const;
+
+        /**
+         * @brief Probe the given device nodes.
+         *
+         * @return One DeviceInfo per path, in the same order; failed probes have their
+         * `error` set.
+         */
+        [[nodiscard]]
+        std::vector<DeviceInfo>
+        scan(std::span<const std::filesystem::path> paths)
+            const;
+
+        /**
+         * @brief Probe the given device nodes, answering from a cache when possible.
+         *
+         * Devices found in `cache` are not opened; the others are probed, and added to
+         * `cache`. Call CapabilityCache::save() to keep them.
+         */
+        [[nodiscard]]
+        std::vector<DeviceInfo>
+        scan(std::span<const std::filesystem::path> paths,
+             CapabilityCache& cache)
+            const;
+
+    }; // class DeviceScanner
+
+} // namespace evdev
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_DOORBELL_HPP
+#define LIBEVDEVXX_DOORBELL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+
+
+namespace evdev {
+
+    /**
+     * @brief A wakeup signal between threads, backed by an `eventfd`.
+     *
+     * ring() can be called from any thread; wait() sleeps until it's rung, and consumes
+     * the pending rings. The file descriptor can also be watched with `epoll`, or
+     * `ppoll()`: it stays readable from ring() until clear(), so one ring wakes up every
+     * thread watching it. That makes it usable as a CancelToken too.
+     */
+    class Doorbell {
+
+        int fd = -1;
+        std::atomic_bool rung = false;
+
+    public:
+
+        /// @throw std::system_error if the `eventfd` can't be created.
+        Doorbell();
+
+        ~Doorbell()
+            noexcept;
+
+
+        Doorbell(const Doorbell&) = delete;
+
+        Doorbell&
+        operator =(const Doorbell&) = delete;
+
+
+        void
+        ring()
+            noexcept;
+
+        /// Check if ring() was called since the last clear() or wait().
+        [[nodiscard]]
+        bool
+        is_rung()
+            const noexcept;
+
+        /**
+         * @brief Sleep until ring() is called.
+         *
+         * @param timeout How long to wait; no value means forever.
+         *
+         * @return `true` if it was rung, `false` on timeout or signal.
+         */
+        bool
+        wait(std::optional<std::chrono::milliseconds> timeout = {})
+            noexcept;
+
+        /// Consume pending rings, without waiting; must not race with ring() when the
+        /// ring must not be lost.
+        void
+        clear()
+            noexcept;
+
+
+        [[nodiscard]]
+        int
+        get_fd()
+            const noexcept;
+
+    }; // class Doorbell
+
+} // namespace evdev
+
+#endif
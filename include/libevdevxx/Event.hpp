@@ -26,7 +26,7 @@ namespace evdev {
 
     struct Event {
 
-        // Same fields as ::input_event, but not same memory layout.
+        // Same fields as ::input_event, but not same memory layout; see RawEvent.
         decltype(::input_event::input_event_sec) sec{};
         decltype(::input_event::input_event_usec) usec{};
         Type type;
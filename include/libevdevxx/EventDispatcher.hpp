@@ -0,0 +1,232 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_EVENT_DISPATCHER_HPP
+#define LIBEVDEVXX_EVENT_DISPATCHER_HPP
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "Code.hpp"
+#include "Event.hpp"
+#include "EventFrame.hpp"
+#include "Match.hpp"
+#include "Type.hpp"
+#include "TypeCode.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief Routes events to handlers, through a dense type/code table.
+     *
+     * Every valid type/code pair has a slot in a flat table, holding the index of its
+     * handler; routing an event costs a bounds check and two array lookups, with no
+     * hashing. The table has about 1200 slots, of 2 bytes each.
+     *
+     * When registrations overlap, the last one wins. Events with no handler are passed
+     * to the fallback handler, if any.
+     *
+     * Handlers must not add or remove handlers on the dispatcher that is running them,
+     * since that could destroy the running handler; on(), set_fallback() and remove()
+     * throw `std::logic_error` if they're called during dispatch().
+     */
+    class EventDispatcher {
+
+    public:
+
+        using Handler = std::function<void(const Event& event)>;
+
+    private:
+
+        // offsets[t] is where type t's slots start; offsets[t + 1] is where they end.
+        std::array<std::uint32_t, EV_CNT + 1> offsets;
+
+        // Indices into handlers; 0 means the fallback.
+        std::vector<std::uint16_t> slots;
+
+        // handlers[0] is the fallback.
+        std::vector<Handler> handlers;
+
+        // How many handlers are running; nested dispatch() calls are allowed.
+        mutable unsigned dispatching = 0;
+
+        struct DispatchGuard {
+            unsigned& depth;
+
+            explicit
+            DispatchGuard(unsigned& d)
+                noexcept :
+                depth{d}
+            {
+                ++depth;
+            }
+
+            ~DispatchGuard()
+                noexcept
+            {
+                --depth;
+            }
+        };
+
+
+        // Reuses the index of a handler no slot points to, if there is one.
+        std::uint16_t
+        store(Handler handler);
+
+        // Throws if a handler is running.
+        void
+        check_idle()
+            const;
+
+        void
+        check_type(Type type)
+            const;
+
+        void
+        check_range(Type type,
+                    Code first,
+                    Code last)
+            const;
+
+        void
+        fill(Type type,
+             Code first,
+             Code last,
+             std::uint16_t index)
+            noexcept;
+
+    public:
+
+        /// @throw std::bad_alloc
+        EventDispatcher();
+
+
+        /// Handle a single type/code.
+        void
+        on(TypeCode tc,
+           Handler handler);
+
+        /**
+         * @brief Handle a range of codes, `[first, last]`, of the same type.
+         *
+         * @throw std::invalid_argument if the range is invalid for `type`.
+         */
+        void
+        on(Type type,
+           Code first,
+           Code last,
+           Handler handler);
+
+        /**
+         * @brief Handle all codes of a type.
+         *
+         * @throw std::invalid_argument if the type is invalid, or has no codes.
+         */
+        void
+        on(Type type,
+           Handler handler);
+
+        /**
+         * @brief Handle every type/code accepted by a compile-time matcher.
+         *
+         * The matcher is only evaluated here, to fill the table.
+         */
+        template<Matcher M>
+        void
+        on(M,
+           Handler handler)
+        {
+            check_idle();
+            const std::uint16_t index = store(std::move(handler));
+            for (std::uint16_t t = 0; t < EV_CNT; ++t)
+                for (std::uint32_t i = offsets[t]; i < offsets[t + 1]; ++i)
+                    if (M::test(t, i - offsets[t]))
+                        slots[i] = index;
+        }
+
+        /// Handle events that no other handler takes.
+        void
+        set_fallback(Handler handler);
+
+
+        /**
+         * @brief Remove the handler for a type/code; it goes to the fallback again.
+         *
+         * @throw std::invalid_argument if the type/code is invalid.
+         */
+        void
+        remove(TypeCode tc);
+
+        /**
+         * @brief Remove the handlers for all codes of a type.
+         *
+         * @throw std::invalid_argument if the type is invalid.
+         */
+        void
+        remove(Type type);
+
+        /// Remove all handlers, including the fallback; must not be called during dispatch().
+        void
+        clear()
+            noexcept;
+
+
+        /// Call the handler for `event`.
+        void
+        dispatch(const Event& event)
+            const
+        {
+            const unsigned type = event.type;
+            std::uint16_t index = 0;
+            if (type < EV_CNT) {
+                const std::uint32_t slot = offsets[type] + event.code;
+                if (slot < offsets[type + 1])
+                    index = slots[slot];
+            }
+            if (const Handler& h = handlers[index]) {
+                const DispatchGuard guard{dispatching};
+                h(event);
+            }
+        }
+
+
+        /// Call the handlers for all `events`, in order.
+        void
+        dispatch(std::span<const Event> events)
+            const;
+
+        /// Call the handlers for all events in `frame`, in order.
+        void
+        dispatch(const EventFrame& frame)
+            const;
+
+        /**
+         * @brief Dispatch only the events accepted by a compile-time matcher.
+         *
+         * Rejected events are skipped with a constant bit test, before any table lookup;
+         * they don't reach the fallback either.
+         */
+        template<Matcher M>
+        void
+        dispatch_if(std::span<const Event> events,
+                    M m)
+            const
+        {
+            for (const Event& e : events)
+                if (m(e))
+                    dispatch(e);
+        }
+
+    }; // class EventDispatcher
+
+} // namespace evdev
+
+#endif
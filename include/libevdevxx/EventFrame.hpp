@@ -0,0 +1,173 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_EVENT_FRAME_HPP
+#define LIBEVDEVXX_EVENT_FRAME_HPP
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "Event.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief A reusable buffer for the events of a single frame.
+     *
+     * A frame is the sequence of events up to, and including, a `SYN_REPORT` event.
+     *
+     * Small frames are stored inline; larger frames spill into a heap buffer that is kept
+     * across clear() calls, so reusing the same frame does not allocate in the steady
+     * state.
+     *
+     * @sa Device::read_frame()
+     */
+    class EventFrame {
+
+    public:
+
+        /// How many events can be stored without allocating.
+        static constexpr std::size_t inline_capacity = 64;
+
+        using value_type = Event;
+        using iterator = const Event*;
+        using const_iterator = const Event*;
+
+    private:
+
+        std::array<Event, inline_capacity> inline_storage;
+        std::vector<Event> spill;
+        std::size_t count = 0;
+        bool spilled = false;
+        bool valid = true;
+        bool complete = false;
+
+    public:
+
+        constexpr
+        EventFrame()
+            noexcept = default;
+
+
+        /// Remove all events, but keep the allocated storage.
+        void
+        clear()
+            noexcept;
+
+
+        /// Append an event to the frame.
+        void
+        push_back(const Event& event);
+
+
+        [[nodiscard]]
+        std::size_t
+        size()
+            const noexcept
+        {
+            return count;
+        }
+
+
+        [[nodiscard]]
+        bool
+        empty()
+            const noexcept
+        {
+            return count == 0;
+        }
+
+
+        [[nodiscard]]
+        const Event*
+        data()
+            const noexcept
+        {
+            return spilled ? spill.data() : inline_storage.data();
+        }
+
+
+        [[nodiscard]]
+        const Event&
+        operator [](std::size_t idx)
+            const noexcept
+        {
+            return data()[idx];
+        }
+
+
+        [[nodiscard]]
+        const_iterator
+        begin()
+            const noexcept
+        {
+            return data();
+        }
+
+
+        [[nodiscard]]
+        const_iterator
+        end()
+            const noexcept
+        {
+            return data() + count;
+        }
+
+
+        /// Return the events as a span.
+        [[nodiscard]]
+        std::span<const Event>
+        events()
+            const noexcept
+        {
+            return {data(), count};
+        }
+
+
+        /// Check if the frame ended with a `SYN_REPORT`.
+        [[nodiscard]]
+        bool
+        is_complete()
+            const noexcept
+        {
+            return complete;
+        }
+
+
+        void
+        set_complete(bool c = true)
+            noexcept
+        {
+            complete = c;
+        }
+
+
+        /// Check if the frame was not cut short by a `SYN_DROPPED`.
+        [[nodiscard]]
+        bool
+        is_valid()
+            const noexcept
+        {
+            return valid;
+        }
+
+
+        void
+        set_valid(bool v)
+            noexcept
+        {
+            valid = v;
+        }
+
+    }; // class EventFrame
+
+} // namespace evdev
+
+#endif
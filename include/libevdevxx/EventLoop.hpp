@@ -0,0 +1,383 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_EVENT_LOOP_HPP
+#define LIBEVDEVXX_EVENT_LOOP_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/epoll.h>
+
+#include "Device.hpp"
+#include "Event.hpp"
+#include "Uinput.hpp"
+
+
+namespace evdev {
+
+    namespace detail {
+        struct Uring;
+    }
+
+
+    /**
+     * @brief Wait for events on many devices at once, using `epoll` or `io_uring`.
+     *
+     * Devices, Uinput devices, signals, timers and arbitrary file descriptors are
+     * registered in a single `epoll` set; run() then sleeps until any of them is ready,
+     * and calls the associated handler.
+     *
+     * When a Device becomes readable, all of its pending events are read, in batches, and
+     * passed to the handler. A `SYN_DROPPED` is passed to the handler like any other
+     * event, followed by the delta events from the resync.
+     *
+     * Handlers are called from the thread running run(). It's safe to add or remove
+     * entries from inside a handler, including the one being called. Only stop() and
+     * post() may be called from other threads.
+     *
+     * With Backend::io_uring, a read is kept outstanding on every Device, so a batch of
+     * events costs no system calls beyond the shared `io_uring_enter()`. The events are
+     * fed into the libevdev state before the handler is called, and a `SYN_DROPPED`
+     * triggers a resync through libevdev, exactly like the `epoll` backend. Removing a
+     * device waits for its outstanding read to be cancelled; if the read already took
+     * events from the device, they're passed to the handler before remove() returns.
+     */
+    class EventLoop {
+
+    public:
+
+        /// How the EventLoop waits for events.
+        enum class Backend {
+            epoll,    ///< Use `epoll`, reading with libevdev when a device is ready.
+            io_uring, ///< Use `io_uring`, with reads posted in advance on every device.
+        };
+
+
+        /// Called with a batch of events read from a Device.
+        using DeviceHandler = std::function<void(Device& dev,
+                                                 std::span<const Event> events)>;
+
+        /// Called when reading from a Device fails; the device is removed from the loop.
+        using ErrorHandler = std::function<void(Device& dev,
+                                                std::error_code error)>;
+
+        /// Called with a batch of events read from a Uinput device (LEDs, force feedback).
+        using UinputHandler = std::function<void(Uinput& udev,
+                                                 std::span<const Event> events)>;
+
+        /// Called when a file descriptor is ready, with the `epoll` event flags.
+        using FdHandler = std::function<void(int fd,
+                                             std::uint32_t events)>;
+
+        /// Called when a signal is received.
+        using SignalHandler = std::function<void(int signo)>;
+
+        /// Called when a timer expires.
+        using TimerHandler = std::function<void()>;
+
+        /// Identifies a timer; it's the timer's file descriptor.
+        using TimerId = int;
+
+    private:
+
+        enum class Kind {
+            device,
+            uinput,
+            fd,
+            signal,
+            timer,
+        };
+
+        struct Entry {
+            Kind kind;
+            int fd = -1;
+            std::uint32_t events = 0;
+            Device* dev = nullptr;
+            Uinput* udev = nullptr;
+            DeviceHandler on_device;
+            ErrorHandler on_error;
+            UinputHandler on_uinput;
+            FdHandler on_fd;
+            SignalHandler on_signal;
+            TimerHandler on_timer;
+            int signo = 0;
+            // set by remove(), so handlers still running can notice
+            bool removed = false;
+
+            // io_uring state
+            std::vector<::input_event> raw_buffer;
+            unsigned pending = 0;
+        };
+
+        int epoll_fd = -1;
+        int wakeup_fd = -1;
+        // Set by stop(), cleared when run() returns; a stop() before run() is kept.
+        std::atomic_bool stop_requested = false;
+
+        // Entries are shared, so a handler can remove itself while it's running.
+        std::unordered_map<int, std::shared_ptr<Entry>> entries;
+
+        std::vector<Event> buffer;
+        std::array<::epoll_event, 64> ready;
+
+        std::mutex post_mutex;
+        std::vector<std::function<void()>> posted;
+
+        std::unique_ptr<detail::Uring> uring;
+        std::shared_ptr<Entry> wakeup_entry;
+        // Removed entries that still have io_uring requests in flight.
+        std::vector<std::shared_ptr<Entry>> retired;
+        // Completions taken from the ring by uring_reap(), for other entries.
+        std::vector<std::pair<std::uint64_t, int>> deferred;
+
+
+        void
+        insert(int fd,
+               std::uint32_t events,
+               std::shared_ptr<Entry> entry);
+
+        void
+        dispatch(int fd,
+                 std::uint32_t events);
+
+        void
+        drain(int fd,
+              Entry& entry,
+              ReadFlag flags = ReadFlag::normal);
+
+        void
+        drain_uinput(int fd,
+                     Entry& entry);
+
+        void
+        fail(int fd,
+             Entry& entry,
+             int error);
+
+        void
+        wake_up()
+            noexcept;
+
+        void
+        run_posted();
+
+
+        void
+        uring_init();
+
+        void
+        uring_destroy()
+            noexcept;
+
+        void
+        uring_arm(Entry& entry);
+
+        void
+        uring_cancel(Entry& entry);
+
+        std::size_t
+        uring_run_once(std::optional<std::chrono::milliseconds> timeout);
+
+        void
+        uring_complete(std::uint64_t data,
+                       int result);
+
+        void
+        uring_reap(Entry& entry);
+
+        void
+        uring_deliver(Entry& entry,
+                      std::size_t count,
+                      std::span<Event> out);
+
+    public:
+
+        /// The default size of the buffer used to read events.
+        static constexpr std::size_t default_batch_size = 256;
+
+
+        /**
+         * @brief Constructor.
+         *
+         * @param batch_size How many events are read from a device at a time.
+         *
+         * @throw std::system_error
+         */
+        explicit
+        EventLoop(std::size_t batch_size = default_batch_size);
+
+        /**
+         * @brief Constructor with a specific backend.
+         *
+         * If the backend is not supported, this falls back to Backend::epoll.
+         *
+         * @throw std::system_error
+         *
+         * @sa get_backend()
+         */
+        explicit
+        EventLoop(Backend backend,
+                  std::size_t batch_size = default_batch_size);
+
+        ~EventLoop()
+            noexcept;
+
+
+        EventLoop(const EventLoop&) = delete;
+
+        EventLoop&
+        operator =(const EventLoop&) = delete;
+
+
+        /**
+         * @brief Check if a backend can be used.
+         *
+         * Backend::io_uring is only available if libevdevxx was built with liburing, and
+         * the kernel allows `io_uring` to be used.
+         */
+        [[nodiscard]]
+        static
+        bool
+        is_supported(Backend backend)
+            noexcept;
+
+        /// The backend in use.
+        [[nodiscard]]
+        Backend
+        get_backend()
+            const noexcept;
+
+
+        /**
+         * @brief Watch a device for events.
+         *
+         * The device must outlive its registration, and its file descriptor should be in
+         * non-blocking mode.
+         *
+         * @param dev The device to read from.
+         *
+         * @param handler Called with every batch of events read.
+         *
+         * @param on_error Called if reading fails (for instance, if the device was
+         * unplugged.) If empty, the error is thrown from run().
+         */
+        void
+        add(Device& dev,
+            DeviceHandler handler,
+            ErrorHandler on_error = {});
+
+        /**
+         * @brief Watch a Uinput device for events sent to it.
+         *
+         * The Uinput file descriptor is switched to non-blocking mode.
+         */
+        void
+        add(Uinput& udev,
+            UinputHandler handler);
+
+        /// Watch a generic file descriptor, with the given `epoll` flags.
+        void
+        add(int fd,
+            std::uint32_t events,
+            FdHandler handler);
+
+
+        void
+        remove(const Device& dev);
+
+        void
+        remove(const Uinput& udev);
+
+        void
+        remove(int fd);
+
+
+        /**
+         * @brief Handle a signal through a `signalfd`.
+         *
+         * The signal is blocked in the calling thread; for it to be reliably delivered
+         * here, it should also be blocked in every other thread.
+         */
+        void
+        add_signal(int signo,
+                   SignalHandler handler);
+
+        /// Stop handling a signal, and unblock it in the calling thread.
+        void
+        remove_signal(int signo);
+
+
+        /**
+         * @brief Create a timer, through a `timerfd`.
+         *
+         * @param delay Time until the first expiration.
+         *
+         * @param interval Time between subsequent expirations; zero means it only expires
+         * once.
+         *
+         * @param handler Called on every expiration.
+         *
+         * @return An identifier to remove the timer.
+         */
+        TimerId
+        add_timer(std::chrono::nanoseconds delay,
+                  std::chrono::nanoseconds interval,
+                  TimerHandler handler);
+
+        void
+        remove_timer(TimerId id);
+
+
+        /**
+         * @brief Wait once for ready entries, and call their handlers.
+         *
+         * @param timeout How long to wait; no value means forever.
+         *
+         * @return How many entries were ready.
+         */
+        std::size_t
+        run_once(std::optional<std::chrono::milliseconds> timeout = {});
+
+        /// Call run_once() until stop() is called.
+        void
+        run();
+
+        /**
+         * @brief Make run() return.
+         *
+         * This can be called from any thread, or from a handler. If run() is not
+         * running, the next call to it returns right away.
+         */
+        void
+        stop()
+            noexcept;
+
+        /**
+         * @brief Run a function on the thread running the loop.
+         *
+         * This can be called from any thread; the function is called from run_once(), in
+         * the order it was posted. Use it to add or remove entries from other threads.
+         */
+        void
+        post(std::function<void()> command);
+
+    }; // class EventLoop
+
+} // namespace evdev
+
+#endif
@@ -0,0 +1,295 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_EVENT_QUEUE_HPP
+#define LIBEVDEVXX_EVENT_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Doorbell.hpp"
+#include "Event.hpp"
+
+
+namespace evdev {
+
+    namespace detail {
+
+        // Fixed, instead of std::hardware_destructive_interference_size, so the layout
+        // doesn't depend on compiler flags.
+        inline constexpr std::size_t cache_line_size = 64;
+
+    } // namespace detail
+
+
+    /**
+     * @brief A wait-free, single-producer single-consumer ring buffer of events.
+     *
+     * One thread may push, and one (other) thread may pop, without locks. The producer
+     * and consumer indices live on separate cache lines, and each side keeps a cached
+     * copy of the other's index, so the shared cache lines are only touched when the
+     * cached view runs out.
+     *
+     * With a Doorbell, the consumer can sleep in wait_pop(); the producer only rings it
+     * (a system call) when the consumer is actually asleep, never on the fast path.
+     *
+     * @tparam T The element type, usually Event or RawEvent.
+     *
+     * @sa ReaderThread
+     */
+    template<typename T = Event>
+    class EventQueue {
+
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        const std::size_t mask;
+        std::unique_ptr<T[]> buffer;
+        std::unique_ptr<Doorbell> doorbell;
+
+        // consumer side
+        alignas(detail::cache_line_size) std::atomic_size_t head = 0;
+        std::size_t cached_tail = 0;
+
+        // producer side
+        alignas(detail::cache_line_size) std::atomic_size_t tail = 0;
+        std::size_t cached_head = 0;
+
+        alignas(detail::cache_line_size) std::atomic_bool sleeping = false;
+        // Set by wake(), so wait_pop() can tell it from a stale ring.
+        std::atomic_bool woken = false;
+
+
+        void
+        notify()
+            noexcept
+        {
+            if (!doorbell)
+                return;
+            // Pairs with the fence in wait_pop(): either the consumer sees the new tail,
+            // or we see it sleeping.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleeping.load(std::memory_order_relaxed))
+                doorbell->ring();
+        }
+
+    public:
+
+        /**
+         * @brief Constructor.
+         *
+         * @param capacity Minimum capacity; it's rounded up to a power of two.
+         *
+         * @param with_doorbell Create a Doorbell, for wait_pop().
+         */
+        explicit
+        EventQueue(std::size_t capacity,
+                   bool with_doorbell = false) :
+            mask{std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1},
+            buffer{std::make_unique_for_overwrite<T[]>(mask + 1)}
+        {
+            if (with_doorbell)
+                doorbell = std::make_unique<Doorbell>();
+        }
+
+
+        EventQueue(const EventQueue&) = delete;
+
+        EventQueue&
+        operator =(const EventQueue&) = delete;
+
+
+        [[nodiscard]]
+        std::size_t
+        capacity()
+            const noexcept
+        {
+            return mask + 1;
+        }
+
+
+        /// How many elements are in the queue; only exact when called from one side.
+        [[nodiscard]]
+        std::size_t
+        size()
+            const noexcept
+        {
+            return tail.load(std::memory_order_acquire)
+                - head.load(std::memory_order_acquire);
+        }
+
+
+        [[nodiscard]]
+        bool
+        empty()
+            const noexcept
+        {
+            return size() == 0;
+        }
+
+
+        // ------------- //
+        // Producer side //
+        // ------------- //
+
+
+        /// Add one element; returns `false` if the queue is full.
+        bool
+        try_push(const T& value)
+            noexcept
+        {
+            return push(std::span<const T>{&value, 1}) == 1;
+        }
+
+
+        /**
+         * @brief Add as many elements as fit.
+         *
+         * @return How many elements from the start of `values` were added.
+         */
+        std::size_t
+        push(std::span<const T> values)
+            noexcept
+        {
+            const std::size_t t = tail.load(std::memory_order_relaxed);
+            std::size_t space = capacity() - (t - cached_head);
+            if (space < values.size()) {
+                cached_head = head.load(std::memory_order_acquire);
+                space = capacity() - (t - cached_head);
+            }
+
+            const std::size_t n = std::min(space, values.size());
+            if (!n)
+                return 0;
+
+            const std::size_t start = t & mask;
+            const std::size_t first = std::min(n, capacity() - start);
+            std::copy_n(values.data(), first, buffer.get() + start);
+            std::copy_n(values.data() + first, n - first, buffer.get());
+
+            tail.store(t + n, std::memory_order_release);
+            notify();
+            return n;
+        }
+
+
+        // ------------- //
+        // Consumer side //
+        // ------------- //
+
+
+        /// Remove one element; returns `false` if the queue is empty.
+        bool
+        try_pop(T& value)
+            noexcept
+        {
+            return pop(std::span<T>{&value, 1}) == 1;
+        }
+
+
+        /**
+         * @brief Remove as many elements as available, up to `out.size()`.
+         *
+         * @return How many elements were stored in `out`.
+         */
+        std::size_t
+        pop(std::span<T> out)
+            noexcept
+        {
+            const std::size_t h = head.load(std::memory_order_relaxed);
+            std::size_t available = cached_tail - h;
+            if (available < out.size()) {
+                cached_tail = tail.load(std::memory_order_acquire);
+                available = cached_tail - h;
+            }
+
+            const std::size_t n = std::min(available, out.size());
+            if (!n)
+                return 0;
+
+            const std::size_t start = h & mask;
+            const std::size_t first = std::min(n, capacity() - start);
+            std::copy_n(buffer.get() + start, first, out.data());
+            std::copy_n(buffer.get(), n - first, out.data() + first);
+
+            head.store(h + n, std::memory_order_release);
+            return n;
+        }
+
+
+        /**
+         * @brief Remove elements, sleeping on the Doorbell while the queue is empty.
+         *
+         * @param timeout How long to sleep; no value means forever.
+         *
+         * Spurious wakeups are waited through, until the timeout expires.
+         *
+         * @return How many elements were stored in `out`; zero means timeout, or a call
+         * to wake().
+         *
+         * @throw std::logic_error if the queue has no Doorbell.
+         */
+        std::size_t
+        wait_pop(std::span<T> out,
+                 std::optional<std::chrono::milliseconds> timeout = {})
+        {
+            if (!doorbell)
+                throw std::logic_error{"EventQueue::wait_pop() needs a doorbell."};
+
+            if (std::size_t n = pop(out))
+                return n;
+
+            using clock = std::chrono::steady_clock;
+            const auto deadline = clock::now() + timeout.value_or(std::chrono::milliseconds::zero());
+
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::size_t n = 0;
+            // A ring may be left over from a push the last call didn't need to wait
+            // for, so waking up doesn't mean there's anything to pop.
+            while (!(n = pop(out)) && !woken.exchange(false, std::memory_order_acquire)) {
+                std::optional<std::chrono::milliseconds> left;
+                if (timeout) {
+                    left = std::chrono::ceil<std::chrono::milliseconds>(deadline
+                                                                        - clock::now());
+                    if (left->count() <= 0)
+                        break;
+                }
+                doorbell->wait(left);
+            }
+            sleeping.store(false, std::memory_order_relaxed);
+            return n;
+        }
+
+
+        /**
+         * @brief Make a consumer sleeping in wait_pop() return, even with an empty queue.
+         *
+         * If the consumer is not sleeping, its next wait_pop() returns right away.
+         */
+        void
+        wake()
+            noexcept
+        {
+            if (!doorbell)
+                return;
+            woken.store(true, std::memory_order_release);
+            doorbell->ring();
+        }
+
+    }; // class EventQueue
+
+} // namespace evdev
+
+#endif
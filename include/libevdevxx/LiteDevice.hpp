@@ -0,0 +1,219 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_LITE_DEVICE_HPP
+#define LIBEVDEVXX_LITE_DEVICE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+
+#include <fcntl.h>
+
+#include <libevdev/libevdev.h>
+
+#include "AbsInfo.hpp"
+#include "Capabilities.hpp"
+#include "Code.hpp"
+#include "RawEvent.hpp"
+#include "ReadStatus.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief An input device without libevdev: just the file descriptor.
+     *
+     * A Device always carries a full libevdev context, with its code bitmaps, axis
+     * table, per-slot multitouch state and event queue, which are kilobytes per device,
+     * allocated and filled with ioctls as soon as it's opened. A LiteDevice is only the
+     * file descriptor and two null pointers, until the metadata is asked for; the
+     * identity strings and the Capabilities are then fetched once, and kept.
+     *
+     * There's no shadow state: reads return exactly what the kernel sends, and a
+     * `SYN_DROPPED` is only reported, not recovered from. Use a Device if the current
+     * state of keys, axes or touches must be queried.
+     *
+     * The lazy getters are not thread-safe.
+     */
+    class LiteDevice {
+
+        int fd = -1;
+        bool owned = false;
+
+        struct Identity {
+            std::string name;
+            std::optional<std::string> phys;
+            std::optional<std::string> uniq;
+            ::input_id id;
+            int driver_version;
+        };
+
+        mutable std::unique_ptr<Identity> identity;
+        mutable std::unique_ptr<Capabilities> caps;
+
+
+        const Identity&
+        get_identity()
+            const;
+
+    public:
+
+        /// Create an invalid object.
+        LiteDevice()
+            noexcept;
+
+        /**
+         * @brief Open a device file.
+         *
+         * @throw std::system_error
+         */
+        explicit
+        LiteDevice(const std::filesystem::path& filename,
+                   int flags = O_RDONLY | O_NONBLOCK);
+
+        /// Use a file descriptor that is already open; it's not closed here.
+        explicit
+        LiteDevice(int fd)
+            noexcept;
+
+        ~LiteDevice()
+            noexcept;
+
+
+        LiteDevice(LiteDevice&& other)
+            noexcept;
+
+        LiteDevice&
+        operator =(LiteDevice&& other)
+            noexcept;
+
+
+        /// Check if there's a file descriptor.
+        [[nodiscard]]
+        explicit
+        operator bool()
+            const noexcept;
+
+        /// Close the file descriptor, if owned, and forget the metadata.
+        void
+        close()
+            noexcept;
+
+        [[nodiscard]]
+        int
+        get_fd()
+            const noexcept;
+
+
+        // --------------------------- //
+        // Metadata, fetched on demand //
+        // --------------------------- //
+
+
+        [[nodiscard]]
+        const std::string&
+        get_name()
+            const;
+
+        [[nodiscard]]
+        const std::optional<std::string>&
+        get_phys()
+            const;
+
+        [[nodiscard]]
+        const std::optional<std::string>&
+        get_uniq()
+            const;
+
+        [[nodiscard]]
+        std::uint16_t
+        get_bustype()
+            const;
+
+        [[nodiscard]]
+        std::uint16_t
+        get_vendor()
+            const;
+
+        [[nodiscard]]
+        std::uint16_t
+        get_product()
+            const;
+
+        [[nodiscard]]
+        std::uint16_t
+        get_version()
+            const;
+
+        [[nodiscard]]
+        int
+        get_driver_version()
+            const;
+
+        [[nodiscard]]
+        const Capabilities&
+        get_capabilities()
+            const;
+
+
+        /// The current state of an axis, queried from the kernel on every call.
+        [[nodiscard]]
+        AbsInfo
+        get_abs_info(Code code)
+            const;
+
+
+        // ------- //
+        // Control //
+        // ------- //
+
+
+        void
+        grab();
+
+        void
+        ungrab();
+
+        void
+        set_clock_id(int clockid);
+
+
+        // ------ //
+        // Events //
+        // ------ //
+
+
+        /**
+         * @brief Read as many events as possible, with one system call.
+         *
+         * @param[out] status `ReadStatus::success` if events were read,
+         * `ReadStatus::dropped` if any of them is a `SYN_DROPPED`, `ReadStatus::again`
+         * if no events were available, or a negative `errno` value on error.
+         *
+         * @return How many events were stored in `events`.
+         */
+        std::size_t
+        read(std::span<::input_event> events,
+             ReadStatus& status)
+            noexcept;
+
+        /// Same as above, but with RawEvent storage.
+        std::size_t
+        read(std::span<RawEvent> events,
+             ReadStatus& status)
+            noexcept;
+
+    }; // class LiteDevice
+
+} // namespace evdev
+
+#endif
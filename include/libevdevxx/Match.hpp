@@ -0,0 +1,304 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_MATCH_HPP
+#define LIBEVDEVXX_MATCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <libevdev/libevdev.h>
+
+#include "Device.hpp"
+#include "Event.hpp"
+#include "RawEvent.hpp"
+#include "ReadFlag.hpp"
+#include "ReadStatus.hpp"
+#include "TypeCode.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief A compile-time event filter.
+     *
+     * A matcher is an empty type with a `static constexpr` test() function. Matchers
+     * compose with `&&`, `||` and `!` (or `and`, `or`, `not`), and the result is another
+     * matcher, so the whole expression folds into constant comparisons and bit tests.
+     */
+    template<typename M>
+    concept Matcher = requires(std::uint16_t type, std::uint16_t code) {
+        { M::test(type, code) } noexcept -> std::same_as<bool>;
+    };
+
+
+    namespace detail {
+
+        // Provides the call operators, for all event representations.
+        template<typename D>
+        struct MatcherBase {
+
+            constexpr
+            bool
+            operator ()(const Event& e)
+                const noexcept
+            {
+                return D::test(e.type, e.code);
+            }
+
+
+            constexpr
+            bool
+            operator ()(const ::input_event& e)
+                const noexcept
+            {
+                return D::test(e.type, e.code);
+            }
+
+
+            constexpr
+            bool
+            operator ()(const RawEvent& e)
+                const noexcept
+            {
+                return D::test(e.raw.type, e.raw.code);
+            }
+
+
+            constexpr
+            bool
+            operator ()(TypeCode tc)
+                const noexcept
+            {
+                return D::test(tc.type, tc.code);
+            }
+
+        }; // struct MatcherBase
+
+
+        template<std::uint16_t... Codes>
+        consteval
+        auto
+        make_code_mask()
+        {
+            constexpr std::uint16_t max_code = std::max({std::uint16_t{0}, Codes...});
+            std::array<std::uint64_t, max_code / 64 + 1> mask{};
+            ((mask[Codes / 64] |= std::uint64_t{1} << (Codes % 64)), ...);
+            return mask;
+        }
+
+    } // namespace detail
+
+
+    /// Match a fixed set of codes of one type, e.g. `match<EV_KEY, BTN_LEFT, BTN_RIGHT>`.
+    template<std::uint16_t Type,
+             std::uint16_t... Codes>
+    struct match :
+        detail::MatcherBase<match<Type, Codes...>> {
+
+        static_assert(Type <= EV_MAX, "invalid event type");
+        static_assert(sizeof...(Codes) > 0, "use match_type<> to match a whole type");
+
+        static constexpr auto mask = detail::make_code_mask<Codes...>();
+
+        static
+        constexpr
+        bool
+        test(std::uint16_t type,
+             std::uint16_t code)
+            noexcept
+        {
+            return type == Type
+                && code / 64 < mask.size()
+                && (mask[code / 64] >> (code % 64)) & 1;
+        }
+
+    }; // struct match
+
+
+    /// Match codes in `[First, Last]` of one type.
+    template<std::uint16_t Type,
+             std::uint16_t First,
+             std::uint16_t Last>
+    struct match_range :
+        detail::MatcherBase<match_range<Type, First, Last>> {
+
+        static_assert(Type <= EV_MAX, "invalid event type");
+        static_assert(First <= Last, "invalid code range");
+
+        static
+        constexpr
+        bool
+        test(std::uint16_t type,
+             std::uint16_t code)
+            noexcept
+        {
+            // one unsigned comparison covers both bounds
+            return type == Type
+                && static_cast<std::uint16_t>(code - First) <= Last - First;
+        }
+
+    }; // struct match_range
+
+
+    /// Match all codes of one type.
+    template<std::uint16_t Type>
+    struct match_type :
+        detail::MatcherBase<match_type<Type>> {
+
+        static_assert(Type <= EV_MAX, "invalid event type");
+
+        static
+        constexpr
+        bool
+        test(std::uint16_t type,
+             std::uint16_t)
+            noexcept
+        {
+            return type == Type;
+        }
+
+    }; // struct match_type
+
+
+    /// Matches if all matchers match.
+    template<Matcher... Ms>
+    struct match_all :
+        detail::MatcherBase<match_all<Ms...>> {
+
+        static
+        constexpr
+        bool
+        test(std::uint16_t type,
+             std::uint16_t code)
+            noexcept
+        {
+            return (Ms::test(type, code) && ...);
+        }
+
+    }; // struct match_all
+
+
+    /// Matches if any matcher matches.
+    template<Matcher... Ms>
+    struct match_any :
+        detail::MatcherBase<match_any<Ms...>> {
+
+        static
+        constexpr
+        bool
+        test(std::uint16_t type,
+             std::uint16_t code)
+            noexcept
+        {
+            return (Ms::test(type, code) || ...);
+        }
+
+    }; // struct match_any
+
+
+    /// Matches if the matcher doesn't match.
+    template<Matcher M>
+    struct match_none :
+        detail::MatcherBase<match_none<M>> {
+
+        static
+        constexpr
+        bool
+        test(std::uint16_t type,
+             std::uint16_t code)
+            noexcept
+        {
+            return !M::test(type, code);
+        }
+
+    }; // struct match_none
+
+
+    template<Matcher A,
+             Matcher B>
+    constexpr
+    match_all<A, B>
+    operator &&(A, B)
+        noexcept
+    {
+        return {};
+    }
+
+
+    template<Matcher A,
+             Matcher B>
+    constexpr
+    match_any<A, B>
+    operator ||(A, B)
+        noexcept
+    {
+        return {};
+    }
+
+
+    template<Matcher M>
+    constexpr
+    match_none<M>
+    operator !(M)
+        noexcept
+    {
+        return {};
+    }
+
+
+    /**
+     * @brief Remove, in place, the events that don't match.
+     *
+     * The relative order of the kept events is preserved.
+     *
+     * @return How many events were kept, at the start of `events`.
+     */
+    template<typename T,
+             Matcher M>
+    std::size_t
+    filter(std::span<T> events,
+           M m)
+        noexcept
+    {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < events.size(); ++i)
+            if (m(events[i]))
+                events[kept++] = events[i];
+        return kept;
+    }
+
+
+    /**
+     * @brief Read a batch of events, keeping only those that match.
+     *
+     * This is Device::read_batch(), followed by filter(). Note that `SYN_DROPPED` and
+     * `SYN_REPORT` are removed too, unless the matcher accepts them.
+     *
+     * @return How many events were stored in `events`.
+     */
+    template<typename T,
+             Matcher M>
+    std::size_t
+    read_filtered(Device& dev,
+                  std::span<T> events,
+                  ReadStatus& status,
+                  M m,
+                  ReadFlag flags = ReadFlag::normal)
+        noexcept
+    {
+        std::size_t count = dev.read_batch(events, status, flags);
+        return filter(events.first(count), m);
+    }
+
+} // namespace evdev
+
+#endif
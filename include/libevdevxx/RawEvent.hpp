@@ -0,0 +1,226 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_RAW_EVENT_HPP
+#define LIBEVDEVXX_RAW_EVENT_HPP
+
+#include <concepts>
+#include <cstdint>
+#include <iosfwd>
+#include <ranges>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#include <libevdev/libevdev.h>
+
+#include "Code.hpp"
+#include "Event.hpp"
+#include "Type.hpp"
+#include "TypeCode.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief An event with the same memory layout as `::input_event`.
+     *
+     * Unlike Event, arrays of `RawEvent` can be used directly as buffers for the kernel,
+     * or for recordings, without copying. The typed accessors convert on the fly.
+     *
+     * @sa as_raw_events()
+     * @sa as_input_events()
+     */
+    struct RawEvent {
+
+        ::input_event raw{};
+
+
+        constexpr
+        RawEvent()
+            noexcept = default;
+
+
+        constexpr
+        RawEvent(const ::input_event& e)
+            noexcept :
+            raw{e}
+        {}
+
+
+        RawEvent(const Event& e)
+            noexcept :
+            raw(static_cast<::input_event>(e))
+        {}
+
+
+        [[nodiscard]]
+        constexpr
+        auto
+        get_sec()
+            const noexcept
+        {
+            return raw.input_event_sec;
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        auto
+        get_usec()
+            const noexcept
+        {
+            return raw.input_event_usec;
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        Type
+        get_type()
+            const noexcept
+        {
+            return Type{raw.type};
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        Code
+        get_code()
+            const noexcept
+        {
+            return Code{raw.code};
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        TypeCode
+        get_type_code()
+            const noexcept
+        {
+            return {get_type(), get_code()};
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        std::int32_t
+        get_value()
+            const noexcept
+        {
+            return raw.value;
+        }
+
+
+        constexpr
+        void
+        set_type(Type type)
+            noexcept
+        {
+            raw.type = type;
+        }
+
+
+        constexpr
+        void
+        set_code(Code code)
+            noexcept
+        {
+            raw.code = code;
+        }
+
+
+        constexpr
+        void
+        set_value(std::int32_t value)
+            noexcept
+        {
+            raw.value = value;
+        }
+
+
+        constexpr
+        operator const ::input_event&()
+            const noexcept
+        {
+            return raw;
+        }
+
+
+        constexpr
+        operator Event()
+            const noexcept
+        {
+            return Event{raw};
+        }
+
+    }; // struct RawEvent
+
+
+    static_assert(sizeof(RawEvent) == sizeof(::input_event));
+    static_assert(alignof(RawEvent) == alignof(::input_event));
+    static_assert(std::is_standard_layout_v<RawEvent>);
+    static_assert(std::is_trivially_copyable_v<RawEvent>);
+
+
+    namespace detail {
+
+        // Element type of a contiguous range, keeping its constness.
+        template<std::ranges::contiguous_range R>
+        using range_element_t = std::remove_reference_t<std::ranges::range_reference_t<R>>;
+
+
+        // Apply the constness of From to To.
+        template<typename From,
+                 typename To>
+        using copy_const_t = std::conditional_t<std::is_const_v<From>, const To, To>;
+
+    } // namespace detail
+
+
+    /// View an array of `::input_event` as an array of `RawEvent`, without copying.
+    template<std::ranges::contiguous_range R>
+    requires std::same_as<std::ranges::range_value_t<R>, ::input_event>
+    [[nodiscard]]
+    std::span<detail::copy_const_t<detail::range_element_t<R>, RawEvent>>
+    as_raw_events(R&& events)
+        noexcept
+    {
+        using T = detail::copy_const_t<detail::range_element_t<R>, RawEvent>;
+        return {reinterpret_cast<T*>(std::ranges::data(events)),
+                std::ranges::size(events)};
+    }
+
+
+    /// View an array of `RawEvent` as an array of `::input_event`, without copying.
+    template<std::ranges::contiguous_range R>
+    requires std::same_as<std::ranges::range_value_t<R>, RawEvent>
+    [[nodiscard]]
+    std::span<detail::copy_const_t<detail::range_element_t<R>, ::input_event>>
+    as_input_events(R&& events)
+        noexcept
+    {
+        using T = detail::copy_const_t<detail::range_element_t<R>, ::input_event>;
+        return {reinterpret_cast<T*>(std::ranges::data(events)),
+                std::ranges::size(events)};
+    }
+
+
+    [[nodiscard]]
+    std::string
+    to_string(const RawEvent& e);
+
+
+    std::ostream&
+    operator <<(std::ostream& out,
+                const RawEvent& e);
+
+} // namespace evdev
+
+#endif
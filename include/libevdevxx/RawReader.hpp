@@ -0,0 +1,104 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_RAW_READER_HPP
+#define LIBEVDEVXX_RAW_READER_HPP
+
+#include <cstddef>
+#include <span>
+
+#include <libevdev/libevdev.h>
+
+#include "Device.hpp"
+#include "RawEvent.hpp"
+#include "ReadStatus.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief Read events directly from the device file, bypassing libevdev's queue.
+     *
+     * Each call to read() is a single `read()` system call on Device::get_fd(), storing
+     * as many events as fit into the caller's buffer. This is intended for grabbed
+     * devices that are only forwarded elsewhere.
+     *
+     * By default the libevdev state of the Device is not updated, so queries like
+     * Device::get_value() will return stale values. Use Mode::track_state to feed the
+     * events into the libevdev state after they are read.
+     *
+     * Don't mix this with Device::read() on the same device: events already queued
+     * inside libevdev are not seen by this reader.
+     *
+     * @sa Grabber
+     */
+    class RawReader {
+
+    public:
+
+        /// How the events are handled after being read.
+        enum class Mode {
+            pass_through, ///< Do not touch the libevdev state.
+            track_state,  ///< Update the libevdev state with the events read.
+        };
+
+    private:
+
+        Device* dev = nullptr;
+        Mode mode = Mode::pass_through;
+
+    public:
+
+        RawReader()
+            noexcept;
+
+        RawReader(Device& d,
+                  Mode m = Mode::pass_through)
+            noexcept;
+
+
+        [[nodiscard]]
+        Mode
+        get_mode()
+            const noexcept;
+
+        void
+        set_mode(Mode m)
+            noexcept;
+
+
+        /**
+         * @brief Read as many events as possible, with one system call.
+         *
+         * @param events Where to store the events.
+         *
+         * @param[out] status `ReadStatus::success` if events were read,
+         * `ReadStatus::dropped` if any of them is a `SYN_DROPPED`, `ReadStatus::again`
+         * if no events were available, or a negative `errno` value on error.
+         *
+         * After a `SYN_DROPPED` in Mode::track_state, the libevdev state is out of date;
+         * use Device::read() with `ReadFlag::force_sync`, followed by `ReadFlag::resync`,
+         * to bring it up to date.
+         *
+         * @return How many events were stored in `events`.
+         */
+        std::size_t
+        read(std::span<::input_event> events,
+             ReadStatus& status)
+            noexcept;
+
+        /// Same as above, but with RawEvent storage.
+        std::size_t
+        read(std::span<RawEvent> events,
+             ReadStatus& status)
+            noexcept;
+
+    }; // class RawReader
+
+} // namespace evdev
+
+#endif
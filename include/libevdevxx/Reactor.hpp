@@ -0,0 +1,215 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_REACTOR_HPP
+#define LIBEVDEVXX_REACTOR_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Device.hpp"
+#include "EventLoop.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief Spreads devices across several EventLoop threads, one per CPU core.
+     *
+     * Each shard is an EventLoop running on its own thread, optionally pinned to a CPU.
+     * New devices go to the shard with the lowest observed event rate; rebalance() moves
+     * devices from busy shards to idle ones, based on the rates measured since the
+     * previous call.
+     *
+     * Moving a device never loses or reorders events: it's removed from the old shard
+     * on that shard's thread, after its last batch was handled, and only then added to
+     * the new shard. Unread events simply wait in the device until the new shard reads
+     * them. Note that handlers may be called from a different thread after a move, but
+     * never from two threads at the same time.
+     *
+     * All methods are thread-safe, except that remove() and migrate() must not be called
+     * from inside a handler.
+     */
+    class Reactor {
+
+    public:
+
+        using DeviceHandler = EventLoop::DeviceHandler;
+        using ErrorHandler = EventLoop::ErrorHandler;
+
+
+        /// Statistics for one shard.
+        struct ShardStats {
+            int cpu = -1;                 ///< The CPU the shard is pinned to, or -1.
+            std::size_t devices = 0;      ///< How many devices it's reading.
+            std::uint64_t events = 0;     ///< Total events handled.
+            std::uint64_t batches = 0;    ///< Total handler calls.
+            std::uint64_t errors = 0;     ///< Exceptions thrown from handlers.
+            double event_rate = 0;        ///< Events per second, as of the last sample().
+        };
+
+    private:
+
+        struct Shard {
+            EventLoop loop;
+            std::thread thread;
+            std::thread::id thread_id;
+            int cpu = -1;
+            std::atomic_bool stopping = false;
+            std::atomic_size_t devices = 0;
+            std::atomic_uint64_t events = 0;
+            std::atomic_uint64_t batches = 0;
+            std::atomic_uint64_t errors = 0;
+
+            // protected by Reactor::mutex
+            std::uint64_t last_events = 0;
+            double event_rate = 0;
+        };
+
+        struct DeviceState {
+            Device* dev;
+            DeviceHandler handler;
+            ErrorHandler on_error;
+            std::atomic_size_t shard;
+            std::atomic_uint64_t events = 0;
+
+            // protected by Reactor::mutex
+            std::uint64_t last_events = 0;
+            double event_rate = 0;
+        };
+
+        std::vector<std::unique_ptr<Shard>> shards;
+
+        // Serializes remove(), migrate() and rebalance().
+        std::mutex control_mutex;
+
+        mutable std::mutex mutex;
+        std::unordered_map<const Device*, std::shared_ptr<DeviceState>> devices;
+        std::chrono::steady_clock::time_point last_sample;
+
+
+        void
+        attach(Shard& shard,
+               std::shared_ptr<DeviceState> state);
+
+        void
+        call(Shard& shard,
+             std::function<void()> command);
+
+        void
+        move(const std::shared_ptr<DeviceState>& state,
+             std::size_t target);
+
+        void
+        sample_locked();
+
+        void
+        stop_all()
+            noexcept;
+
+    public:
+
+        /**
+         * @brief Start the shard threads.
+         *
+         * @param num_shards How many threads; zero means one per available CPU.
+         *
+         * @param pin Pin shard `i` to the `i`-th CPU the process may run on.
+         *
+         * @throw std::system_error
+         */
+        explicit
+        Reactor(std::size_t num_shards = 0,
+                bool pin = true);
+
+        /// Stop all shards; devices are left untouched.
+        ~Reactor()
+            noexcept;
+
+
+        Reactor(const Reactor&) = delete;
+
+        Reactor&
+        operator =(const Reactor&) = delete;
+
+
+        /// How many shards there are.
+        [[nodiscard]]
+        std::size_t
+        size()
+            const noexcept;
+
+
+        /**
+         * @brief Start reading a device, on the least loaded shard.
+         *
+         * Same as EventLoop::add(), except the handlers are called from a shard thread.
+         * The device must stay alive until remove() returns, or `on_error` is called.
+         *
+         * @return The shard index.
+         */
+        std::size_t
+        add(Device& dev,
+            DeviceHandler handler,
+            ErrorHandler on_error = {});
+
+        /**
+         * @brief Stop reading a device.
+         *
+         * When this returns, no handler for it is running, or will be called.
+         */
+        void
+        remove(const Device& dev);
+
+        /// Move a device to another shard.
+        void
+        migrate(const Device& dev,
+                std::size_t shard);
+
+
+        /// Update the event rates, from the events handled since the previous call.
+        void
+        sample();
+
+        /**
+         * @brief Move devices to even out the event rates across shards.
+         *
+         * This calls sample(), then repeatedly moves the device that best narrows the
+         * gap between the busiest and the idlest shards.
+         *
+         * @param max_moves Upper bound on devices moved.
+         *
+         * @return How many devices were moved.
+         */
+        std::size_t
+        rebalance(std::size_t max_moves = 8);
+
+
+        [[nodiscard]]
+        std::vector<ShardStats>
+        get_stats()
+            const;
+
+        /// The shard currently reading `dev`.
+        [[nodiscard]]
+        std::size_t
+        get_shard(const Device& dev)
+            const;
+
+    }; // class Reactor
+
+} // namespace evdev
+
+#endif
@@ -18,9 +18,11 @@
 namespace evdev {
 
     enum ReadStatus : int {
-        success = LIBEVDEV_READ_STATUS_SUCCESS,
-        dropped = LIBEVDEV_READ_STATUS_SYNC,
-        again   = -EAGAIN
+        success  = LIBEVDEV_READ_STATUS_SUCCESS,
+        dropped  = LIBEVDEV_READ_STATUS_SYNC,
+        again    = -EAGAIN,
+        timeout  = -ETIMEDOUT, ///< Returned by Device::read_for() when time runs out.
+        canceled = -ECANCELED, ///< Returned by Device::read_for() when canceled.
     };
 
 
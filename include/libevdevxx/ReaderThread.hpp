@@ -0,0 +1,121 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_READER_THREAD_HPP
+#define LIBEVDEVXX_READER_THREAD_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <system_error>
+#include <thread>
+
+#include "CancelToken.hpp"
+#include "Device.hpp"
+#include "Event.hpp"
+#include "EventQueue.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief A thread that reads a Device and pushes its events into an EventQueue.
+     *
+     * The thread sleeps in Device::read_for() while the device is idle, and is woken up
+     * immediately by stop(). Events are read in batches; a `SYN_DROPPED` is pushed like
+     * any other event, followed by the resync deltas.
+     *
+     * If the queue is full, the thread yields until the consumer makes room, so no event
+     * is lost; get_stall_count() tells how often that happened.
+     *
+     * The device must be in non-blocking mode, and must not be used by other threads
+     * while the ReaderThread runs.
+     */
+    class ReaderThread {
+
+        Device* dev;
+        EventQueue<Event>* queue;
+        std::size_t batch_size;
+
+        CancelToken token;
+        std::error_code error;
+        std::atomic_bool running = true;
+        std::atomic_uint64_t event_count = 0;
+        std::atomic_uint64_t stall_count = 0;
+
+        std::thread thread;
+
+
+        void
+        pump()
+            noexcept;
+
+        void
+        push_all(std::span<const Event> events)
+            noexcept;
+
+    public:
+
+        /**
+         * @brief Start reading.
+         *
+         * Both `dev` and `queue` must outlive this object.
+         *
+         * @throw std::system_error if the thread can't be started.
+         */
+        ReaderThread(Device& dev,
+                     EventQueue<Event>& queue,
+                     std::size_t batch_size = 256);
+
+        /// Calls stop().
+        ~ReaderThread()
+            noexcept;
+
+
+        ReaderThread(const ReaderThread&) = delete;
+
+        ReaderThread&
+        operator =(const ReaderThread&) = delete;
+
+
+        /// Stop reading, and wait for the thread to finish.
+        void
+        stop()
+            noexcept;
+
+
+        /// Check if the thread is still reading; it stops by itself on read errors.
+        [[nodiscard]]
+        bool
+        is_running()
+            const noexcept;
+
+        /// The read error that stopped the thread; only valid after stop().
+        [[nodiscard]]
+        std::error_code
+        get_error()
+            const noexcept;
+
+
+        /// How many events were pushed into the queue.
+        [[nodiscard]]
+        std::uint64_t
+        get_event_count()
+            const noexcept;
+
+        /// How many times the thread had to wait for room in the queue.
+        [[nodiscard]]
+        std::uint64_t
+        get_stall_count()
+            const noexcept;
+
+    }; // class ReaderThread
+
+} // namespace evdev
+
+#endif
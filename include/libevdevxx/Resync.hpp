@@ -0,0 +1,206 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_RESYNC_HPP
+#define LIBEVDEVXX_RESYNC_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+
+#include "Device.hpp"
+#include "Event.hpp"
+#include "ReadStatus.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief The delta events that recover from a `SYN_DROPPED`, as a range.
+     *
+     * Returned by Device::resync(). Iterating reads the deltas with `ReadFlag::resync`,
+     * one at a time; nothing is thrown, and the statistics are available during and
+     * after the loop:
+     *
+     * @code
+     * Event event;
+     * if (dev.read(event) == ReadStatus::dropped) {
+     *     auto sync = dev.resync();
+     *     for (const Event& delta : sync)
+     *         apply(delta);
+     *     if (sync.was_mid_frame())
+     *         discard_partial_frame();
+     * }
+     * @endcode
+     *
+     * The kernel doesn't report how many events it dropped, and libevdev discards the
+     * events queued after the `SYN_DROPPED` while syncing, so the only loss that can be
+     * counted is the one the caller can act on: the events of the interrupted frame,
+     * that were already delivered but never completed by a `SYN_REPORT`.
+     *
+     * If the iteration stops early, the remaining deltas are still pending in the
+     * device, and will be returned by the next read with `ReadFlag::resync`.
+     */
+    class Resync {
+
+        Device* dev;
+        Event delta;
+        ReadStatus status = ReadStatus::again;
+        bool started = false;
+        std::size_t deltas = 0;
+        std::size_t discarded;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::nanoseconds duration{0};
+
+
+        void
+        advance()
+            noexcept;
+
+    public:
+
+        /// Marks the end of the range.
+        struct Sentinel {};
+
+
+        /// Input iterator over the deltas.
+        class Iterator {
+
+            Resync* parent = nullptr;
+
+        public:
+
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Event;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Event*;
+            using reference = const Event&;
+
+
+            Iterator()
+                noexcept = default;
+
+            explicit
+            Iterator(Resync* parent)
+                noexcept :
+                parent{parent}
+            {}
+
+
+            reference
+            operator *()
+                const noexcept
+            {
+                return parent->delta;
+            }
+
+            pointer
+            operator ->()
+                const noexcept
+            {
+                return &parent->delta;
+            }
+
+
+            Iterator&
+            operator ++()
+                noexcept
+            {
+                parent->advance();
+                return *this;
+            }
+
+            void
+            operator ++(int)
+                noexcept
+            {
+                parent->advance();
+            }
+
+
+            friend
+            bool
+            operator ==(const Iterator& it,
+                        Sentinel)
+                noexcept
+            {
+                return it.parent->is_done();
+            }
+
+        }; // class Iterator
+
+
+        explicit
+        Resync(Device& dev)
+            noexcept;
+
+
+        /// Read the first delta, if not read yet.
+        [[nodiscard]]
+        Iterator
+        begin()
+            noexcept;
+
+        [[nodiscard]]
+        Sentinel
+        end()
+            const noexcept;
+
+
+        /// Check if all deltas were read.
+        [[nodiscard]]
+        bool
+        is_done()
+            const noexcept;
+
+        /**
+         * @brief The status of the last read.
+         *
+         * `ReadStatus::again` means the sync completed; `ReadStatus::dropped` means
+         * there are more deltas. A negative `errno` value means the read failed.
+         */
+        [[nodiscard]]
+        ReadStatus
+        get_status()
+            const noexcept;
+
+
+        /// How many deltas were read so far.
+        [[nodiscard]]
+        std::size_t
+        get_delta_count()
+            const noexcept;
+
+        /**
+         * @brief How many events of the interrupted frame were lost.
+         *
+         * These are the events read after the last `SYN_REPORT`, and before the
+         * `SYN_DROPPED`; their frame will never be completed, so they should be
+         * discarded.
+         */
+        [[nodiscard]]
+        std::size_t
+        get_discarded_count()
+            const noexcept;
+
+        /// Check if the `SYN_DROPPED` happened in the middle of a frame.
+        [[nodiscard]]
+        bool
+        was_mid_frame()
+            const noexcept;
+
+        /// How long it took to read all deltas, or the time spent so far.
+        [[nodiscard]]
+        std::chrono::nanoseconds
+        get_duration()
+            const noexcept;
+
+    }; // class Resync
+
+} // namespace evdev
+
+#endif
@@ -0,0 +1,243 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_SCHEDULER_HPP
+#define LIBEVDEVXX_SCHEDULER_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Device.hpp"
+#include "Event.hpp"
+#include "EventFrame.hpp"
+#include "ReadFlag.hpp"
+#include "ReadStatus.hpp"
+#include "Task.hpp"
+
+
+namespace evdev {
+
+    namespace detail {
+
+        // A suspended coroutine waiting for a file descriptor to become readable.
+        struct Waiter {
+
+            std::coroutine_handle<> handle;
+
+            // Called when the fd is readable; returns false to keep waiting.
+            bool (*try_complete)(Waiter& self) noexcept = nullptr;
+
+        }; // struct Waiter
+
+    } // namespace detail
+
+
+    /**
+     * @brief A single-threaded coroutine scheduler, built on `epoll`.
+     *
+     * Tasks are started with spawn(), and run() resumes them until they all finish. A
+     * Task waiting on a device (through Device::next_event() or Device::next_frame()) is
+     * only resumed when the device's file descriptor becomes readable, and events are
+     * available.
+     *
+     * Each file descriptor is registered in the `epoll` set only once, edge-triggered,
+     * the first time a Task waits on it; waiting on it again costs no system calls beyond
+     * the `epoll_wait()` shared by all tasks. If the file descriptor is closed, call
+     * forget() before its number can be reused.
+     *
+     * Device file descriptors must be in non-blocking mode. Only one Task may wait on a
+     * given file descriptor at a time.
+     *
+     * @sa Task
+     */
+    class Scheduler {
+
+        struct Slot {
+            int fd = -1;
+            detail::Waiter* waiter = nullptr;
+        };
+
+        int epoll_fd = -1;
+        std::size_t waiting = 0;
+
+        std::unordered_map<int, std::unique_ptr<Slot>> slots;
+
+        std::vector<Task::handle_type> tasks;
+        std::vector<std::coroutine_handle<>> ready;
+        std::vector<Task::handle_type> finished;
+
+
+        friend struct Task::promise_type::FinalAwaiter;
+
+        void
+        finish(Task::handle_type h)
+            noexcept;
+
+        void
+        reap();
+
+    public:
+
+        Scheduler();
+
+        ~Scheduler()
+            noexcept;
+
+
+        Scheduler(const Scheduler&) = delete;
+
+        Scheduler&
+        operator =(const Scheduler&) = delete;
+
+
+        /// The Scheduler running on this thread, or `nullptr`.
+        [[nodiscard]]
+        static
+        Scheduler*
+        current()
+            noexcept;
+
+
+        /**
+         * @brief Start a Task.
+         *
+         * The Task will be first resumed from run().
+         *
+         * @throw std::logic_error if the Task is empty or already finished.
+         */
+        void
+        spawn(Task task);
+
+
+        /// How many spawned tasks have not finished yet.
+        [[nodiscard]]
+        std::size_t
+        size()
+            const noexcept;
+
+
+        /**
+         * @brief Resume tasks until all of them finish.
+         *
+         * If a spawned Task exits with an exception, it's rethrown from here; the other
+         * tasks are kept, and run() can be called again.
+         */
+        void
+        run();
+
+
+        /**
+         * @brief Suspend `waiter` until `fd` is readable.
+         *
+         * This is the building block for awaitables; `waiter` must stay alive until it's
+         * resumed.
+         *
+         * @throw std::logic_error if another coroutine is already waiting on `fd`.
+         */
+        void
+        wait_readable(int fd,
+                      detail::Waiter& waiter);
+
+
+        /// Stop watching `fd`; must be called before it's closed, if it was waited on.
+        void
+        forget(int fd)
+            noexcept;
+
+    }; // class Scheduler
+
+
+    /**
+     * @brief Awaitable returned by Device::next_event().
+     *
+     * The result of `co_await` is the Event read. A `SYN_DROPPED` throws SyncError,
+     * unless reading in resync mode; other errors throw `std::system_error`. If it was
+     * created with an output status, nothing is thrown, and the status is stored there.
+     */
+    class EventAwaiter :
+        detail::Waiter {
+
+        Device* dev;
+        ReadFlag flags;
+        Event event;
+        ReadStatus status = ReadStatus::again;
+        ReadStatus* out_status;
+
+        static
+        bool
+        complete(detail::Waiter& self)
+            noexcept;
+
+    public:
+
+        EventAwaiter(Device& dev,
+                     ReadFlag flags,
+                     ReadStatus* out_status = nullptr)
+            noexcept;
+
+
+        bool
+        await_ready()
+            noexcept;
+
+        void
+        await_suspend(std::coroutine_handle<> h);
+
+        Event
+        await_resume();
+
+    }; // class EventAwaiter
+
+
+    /**
+     * @brief Awaitable returned by Device::next_frame().
+     *
+     * The result of `co_await` is the status of Device::read_frame(): either
+     * `ReadStatus::success` (the frame is complete) or `ReadStatus::dropped`. Other errors
+     * throw `std::system_error`.
+     */
+    class FrameAwaiter :
+        detail::Waiter {
+
+        Device* dev;
+        EventFrame* frame;
+        ReadFlag flags;
+        ReadStatus status = ReadStatus::again;
+        std::exception_ptr error;
+
+        static
+        bool
+        complete(detail::Waiter& self)
+            noexcept;
+
+    public:
+
+        FrameAwaiter(Device& dev,
+                     EventFrame& frame,
+                     ReadFlag flags)
+            noexcept;
+
+
+        bool
+        await_ready()
+            noexcept;
+
+        void
+        await_suspend(std::coroutine_handle<> h);
+
+        ReadStatus
+        await_resume();
+
+    }; // class FrameAwaiter
+
+} // namespace evdev
+
+#endif
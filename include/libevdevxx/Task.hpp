@@ -0,0 +1,221 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_TASK_HPP
+#define LIBEVDEVXX_TASK_HPP
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+
+namespace evdev {
+
+    class Scheduler;
+
+
+    /**
+     * @brief A coroutine that returns nothing.
+     *
+     * A Task starts suspended. It's either handed over to Scheduler::spawn(), or
+     * `co_await`ed from another Task, which resumes it immediately and continues after
+     * it finishes; exceptions thrown from it are rethrown in the awaiting coroutine.
+     *
+     * @sa Scheduler
+     */
+    class Task {
+
+    public:
+
+        struct promise_type {
+
+            std::coroutine_handle<> continuation;
+            std::exception_ptr error;
+            Scheduler* owner = nullptr;
+
+
+            Task
+            get_return_object()
+                noexcept
+            {
+                return Task{handle_type::from_promise(*this)};
+            }
+
+
+            std::suspend_always
+            initial_suspend()
+                noexcept
+            {
+                return {};
+            }
+
+
+            struct FinalAwaiter {
+
+                bool
+                await_ready()
+                    const noexcept
+                {
+                    return false;
+                }
+
+
+                std::coroutine_handle<>
+                await_suspend(std::coroutine_handle<promise_type> h)
+                    noexcept;
+
+
+                void
+                await_resume()
+                    const noexcept
+                {}
+
+            }; // struct FinalAwaiter
+
+
+            FinalAwaiter
+            final_suspend()
+                noexcept
+            {
+                return {};
+            }
+
+
+            void
+            return_void()
+                noexcept
+            {}
+
+
+            void
+            unhandled_exception()
+                noexcept
+            {
+                error = std::current_exception();
+            }
+
+        }; // struct promise_type
+
+
+        using handle_type = std::coroutine_handle<promise_type>;
+
+    private:
+
+        handle_type handle;
+
+
+        explicit
+        Task(handle_type h)
+            noexcept :
+            handle{h}
+        {}
+
+    public:
+
+        Task()
+            noexcept = default;
+
+        Task(Task&& other)
+            noexcept :
+            handle{std::exchange(other.handle, {})}
+        {}
+
+        Task&
+        operator =(Task&& other)
+            noexcept
+        {
+            if (this != &other) {
+                if (handle)
+                    handle.destroy();
+                handle = std::exchange(other.handle, {});
+            }
+            return *this;
+        }
+
+        ~Task()
+            noexcept
+        {
+            if (handle)
+                handle.destroy();
+        }
+
+
+        /// Check if this Task holds a coroutine.
+        [[nodiscard]]
+        explicit
+        operator bool()
+            const noexcept
+        {
+            return static_cast<bool>(handle);
+        }
+
+
+        /// Check if the coroutine has finished.
+        [[nodiscard]]
+        bool
+        done()
+            const noexcept
+        {
+            return !handle || handle.done();
+        }
+
+
+        /// Give up ownership of the coroutine.
+        [[nodiscard]]
+        handle_type
+        release()
+            noexcept
+        {
+            return std::exchange(handle, {});
+        }
+
+
+        struct Awaiter {
+
+            handle_type handle;
+
+
+            bool
+            await_ready()
+                const noexcept
+            {
+                return !handle || handle.done();
+            }
+
+
+            std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<> awaiting)
+                noexcept
+            {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+
+            void
+            await_resume()
+                const
+            {
+                if (handle && handle.promise().error)
+                    std::rethrow_exception(handle.promise().error);
+            }
+
+        }; // struct Awaiter
+
+
+        Awaiter
+        operator co_await()
+            const & noexcept
+        {
+            return Awaiter{handle};
+        }
+
+    }; // class Task
+
+} // namespace evdev
+
+#endif
@@ -8,26 +8,103 @@
 #ifndef LIBEVDEVXX_UINPUT_HPP
 #define LIBEVDEVXX_UINPUT_HPP
 
+#include <array>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <optional>
+#include <span>
+#include <string>
 
 #include <libevdev/libevdev-uinput.h>
 
 #include "basic_wrapper.hpp"
+#include "BitSet.hpp"
+#include "Capabilities.hpp"
 #include "Device.hpp"
 #include "Event.hpp"
 
 
 namespace evdev {
 
-    /// A class to send events to a virtual device.
+    struct DeviceInfo;
+
+
+    /**
+     * @brief A class to send events to a virtual device.
+     *
+     * A shadow copy of the device's key, switch and absolute axis state is kept, so
+     * writes that the kernel would discard, because they don't change the state, are
+     * skipped before the system call. So is a `SYN_REPORT` that would end an empty
+     * frame. Multitouch axes (`ABS_MT_SLOT` to `ABS_MT_TOOL_Y`) are not tracked, and
+     * always written. Axes with a nonzero fuzz are filtered like the kernel does: a
+     * small move is ignored or smoothed, so the value kept may not be the one written.
+     *
+     * The keys and switches start released, like any new uinput device; the axes start
+     * with the values of the Device the uinput device was created from.
+     *
+     * A device can be created through libevdev, with create(), or directly with the
+     * uinput ioctls, with create_native(). Either way, the syspath and devnode are only
+     * looked up once.
+     */
     class Uinput :
         public detail::basic_wrapper<libevdev_uinput*> {
 
         using BaseType = detail::basic_wrapper<libevdev_uinput*>;
 
+        // What the kernel was told so far.
+        struct Shadow {
+
+            BitSet<KEY_CNT> keys;
+            BitSet<SW_CNT> switches;
+            BitSet<ABS_CNT> tracked_axes;
+            std::array<std::int32_t, ABS_CNT> axes{};
+            std::array<std::int32_t, ABS_CNT> fuzz{};
+            // Events were written since the last SYN_REPORT.
+            bool frame_pending = false;
+
+            std::uint64_t written = 0;
+            std::uint64_t elided = 0;
+
+
+            // Update the state; returns false if the event should be elided.
+            bool
+            update(std::uint16_t type,
+                   std::uint16_t code,
+                   std::int32_t value)
+                noexcept;
+
+        };
+
+        // Only updated after a successful write.
+        Shadow shadow;
+
+        // Set by create_native(), which leaves `raw` null.
+        int native_fd = -1;
+        bool native_owned = false;
+
+        mutable std::optional<std::filesystem::path> syspath;
+        mutable std::optional<std::filesystem::path> devnode;
+
+
+        void
+        reset_shadow(const Device& dev)
+            noexcept;
+
+        void
+        reset_shadow(const Capabilities& caps)
+            noexcept;
+
+        void
+        create_native(const std::string& name,
+                      const std::optional<std::string>& phys,
+                      const ::input_id& id,
+                      const Capabilities& caps,
+                      unsigned ff_effects_max,
+                      int fd);
+
     public:
 
         Uinput(std::nullptr_t p = nullptr)
@@ -54,11 +131,63 @@ namespace evdev {
         create(const Device& dev,
                int fd = LIBEVDEV_UINPUT_OPEN_MANAGED);
 
+        /**
+         * @brief Create the device with the uinput ioctls, without libevdev.
+         *
+         * The setup is done with `UI_DEV_SETUP` and one `UI_ABS_SETUP` per axis, and the
+         * other codes are enabled by walking the Capabilities bitmaps, so only the codes
+         * that are set cost an ioctl. The syspath and devnode come from
+         * `UI_GET_SYSNAME`, right after creation.
+         *
+         * The codes are taken like Capabilities(const Device&) does: from the kernel if
+         * `dev` has a file descriptor, from libevdev otherwise.
+         *
+         * @param ff_effects_max How many force-feedback effects can be uploaded at once.
+         * If zero, `EV_FF` is left out, even if `dev` supports it. Otherwise, the caller
+         * must service the `UI_BEGIN_FF_UPLOAD` and `UI_BEGIN_FF_ERASE` requests, that
+         * arrive as `EV_UINPUT` events on get_fd(); until they're answered, the
+         * process that uploads or erases the effect is blocked.
+         *
+         * @param fd An open `/dev/uinput` file descriptor, that will not be closed; if
+         * negative, `/dev/uinput` is opened, and closed by destroy().
+         *
+         * @throw std::system_error; also if `UI_GET_SYSNAME` fails (it needs Linux
+         * 3.15), in which case the new device is destroyed.
+         */
+        void
+        create_native(const Device& dev,
+                      unsigned ff_effects_max = 0,
+                      int fd = -1);
+
+        /// Same as above, from a probed device.
+        void
+        create_native(const DeviceInfo& info,
+                      unsigned ff_effects_max = 0,
+                      int fd = -1);
+
         void
         destroy()
             noexcept override;
 
 
+        /// Check if there's a device, created either way.
+        [[nodiscard]]
+        bool
+        is_valid()
+            const noexcept;
+
+        [[nodiscard]]
+        explicit
+        operator bool()
+            const noexcept;
+
+        /// Check if the device was created by create_native(); then data() is null.
+        [[nodiscard]]
+        bool
+        is_native()
+            const noexcept;
+
+
         [[nodiscard]]
         int
         get_fd()
@@ -85,6 +214,42 @@ namespace evdev {
             const;
 
 
+        /**
+         * @brief Wait until the event node can be opened and read.
+         *
+         * The node shows up right after the device is created, but udev may still be
+         * setting its owner, mode and ACLs. This watches the node's directory with
+         * inotify, and tries to open the node, and read from it without blocking,
+         * whenever something is created or changes attributes there, so it returns as
+         * soon as the node is usable. If the devnode is not known yet, it's looked up
+         * again as nodes appear in `/dev/input`.
+         *
+         * Ready only means that this process can open the node: only its access is
+         * checked, so a root process can open the node before udev is done with it, and
+         * other users may still be denied. Nothing is implied about udev rules or
+         * other listeners having seen the device.
+         *
+         * @return `false` if the timeout expired before the node was found and usable.
+         *
+         * @throw std::system_error
+         */
+        [[nodiscard]]
+        bool
+        wait_ready(std::chrono::milliseconds timeout = std::chrono::seconds{2})
+            const;
+
+        /**
+         * @brief Same as above, for many devices, with a single inotify instance.
+         *
+         * @return `false` if any device is not ready when the timeout expires.
+         */
+        [[nodiscard]]
+        static
+        bool
+        wait_ready(std::span<const Uinput* const> devices,
+                   std::chrono::milliseconds timeout = std::chrono::seconds{2});
+
+
         void
         write(Type type,
               Code code,
@@ -97,6 +262,29 @@ namespace evdev {
         void
         write(const Event& event);
 
+        /**
+         * @brief Write many events with a single system call.
+         *
+         * The events are written in order, with one `writev()`, and partial writes are
+         * resumed where they stopped.
+         *
+         * @param events The events to write; their timestamps are ignored, uinput
+         * always stamps events with the time they're received.
+         *
+         * @param sync Append a `SYN_REPORT`, to complete the frame.
+         *
+         * @return How many events were written, not counting the `SYN_REPORT`; the
+         * others were elided.
+         */
+        std::size_t
+        write(std::span<const Event> events,
+              bool sync = false);
+
+        /// Same as above, but with `::input_event` storage, that is written without copies.
+        std::size_t
+        write(std::span<const ::input_event> events,
+              bool sync = false);
+
 
         // convenience methods
 
@@ -151,6 +339,48 @@ namespace evdev {
         void
         flush();
 
+
+        // ------------ //
+        // Shadow state //
+        // ------------ //
+
+
+        /**
+         * @brief The last value written for a key, switch or non-multitouch axis.
+         *
+         * This is answered from the shadow state, with no system call. For keys and
+         * switches, it's 0 or 1; for axes, it's the value after the kernel's fuzz
+         * filter; for other types, it's always 0.
+         */
+        [[nodiscard]]
+        int
+        get_value(Type type,
+                  Code code)
+            const noexcept;
+
+        /// The keys that are currently pressed.
+        [[nodiscard]]
+        const BitSet<KEY_CNT>&
+        get_keys()
+            const noexcept;
+
+
+        /// How many events were written to the kernel.
+        [[nodiscard]]
+        std::uint64_t
+        get_written_count()
+            const noexcept;
+
+        /// How many events were skipped, because they wouldn't change anything.
+        [[nodiscard]]
+        std::uint64_t
+        get_elided_count()
+            const noexcept;
+
+        void
+        reset_counters()
+            noexcept;
+
     }; // class Uinput
 
 } // namespace evdev
@@ -0,0 +1,127 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_UINPUT_FRAME_HPP
+#define LIBEVDEVXX_UINPUT_FRAME_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <libevdev/libevdev.h>
+
+#include "BitSet.hpp"
+#include "Code.hpp"
+#include "Type.hpp"
+#include "Uinput.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief Collects the events of one frame, and writes them all at once.
+     *
+     * Redundant writes are merged before they reach the kernel:
+     *
+     *   - Absolute axes are last-writer-wins: the event stays where it was first
+     *     written, with the last value. Multitouch axes (`ABS_MT_SLOT` to
+     *     `ABS_MT_TOOL_Y`) depend on the current slot, so they're kept as written.
+     *
+     *   - Relative deltas for the same code are summed, saturating at the limits of
+     *     `int32_t`; a zero sum is dropped.
+     *
+     *   - Key writes that don't change the key state are dropped; autorepeats (value
+     *     2) are always kept. The key state starts from the Uinput's shadow state,
+     *     and is reset to it by clear().
+     *
+     * flush() writes the frame and a `SYN_REPORT` with a single system call.
+     */
+    class UinputFrame {
+
+        static constexpr std::int32_t none = -1;
+
+        Uinput* udev;
+        std::vector<::input_event> events;
+
+        // Where the pending event of each axis is, in `events`.
+        std::array<std::int32_t, ABS_CNT> abs_index;
+        std::array<std::int32_t, REL_CNT> rel_index;
+
+        BitSet<KEY_CNT> keys_down;
+
+
+        void
+        append(std::uint16_t type,
+               std::uint16_t code,
+               std::int32_t value);
+
+        void
+        reindex()
+            noexcept;
+
+    public:
+
+        explicit
+        UinputFrame(Uinput& udev);
+
+
+        void
+        write_key(Code code,
+                  int value);
+
+        void
+        write_abs(Code code,
+                  int value);
+
+        void
+        write_rel(Code code,
+                  int value);
+
+        /// Write any event; key, abs and rel events are merged like above.
+        void
+        write(Type type,
+              Code code,
+              int value);
+
+
+        /// How many events are pending.
+        [[nodiscard]]
+        std::size_t
+        size()
+            const noexcept;
+
+        [[nodiscard]]
+        bool
+        empty()
+            const noexcept;
+
+
+        /**
+         * @brief Write the pending events, followed by a `SYN_REPORT`.
+         *
+         * Nothing is written if no events are left after merging. The Uinput may elide
+         * some more, if they don't change its shadow state.
+         *
+         * @return How many events were written, not counting the `SYN_REPORT`.
+         *
+         * @throw std::system_error; the pending events are kept, and flush() can be
+         * called again.
+         */
+        std::size_t
+        flush();
+
+        /// Discard the pending events; the key state goes back to the Uinput's.
+        void
+        clear()
+            noexcept;
+
+    }; // class UinputFrame
+
+} // namespace evdev
+
+#endif
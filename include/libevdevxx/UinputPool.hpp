@@ -0,0 +1,194 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_UINPUT_POOL_HPP
+#define LIBEVDEVXX_UINPUT_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Device.hpp"
+#include "DeviceInfo.hpp"
+#include "Uinput.hpp"
+
+
+namespace evdev {
+
+    /**
+     * @brief Keeps released uinput devices around, to hand them out again.
+     *
+     * Creating a uinput device costs kernel and udev work; a pool skips it when a device
+     * with the same fingerprint was used before: the same name, `phys`, ids and
+     * Capabilities (axis values are not part of it); see DeviceInfo::fingerprint().
+     *
+     * When a Lease ends, the device is put back into a neutral state (keys and switches
+     * released, absolute axes centered between their minimum and maximum, multitouch
+     * contacts lifted, and the Uinput counters reset) and kept idle, up to a limit per
+     * fingerprint; beyond that, it's destroyed. So a reused device starts with its axes
+     * centered, not with the values of the source; an axis with fuzz may end up less
+     * than its fuzz away from the center, since the kernel smooths small moves.
+     *
+     * Devices are created with Uinput::create_native(). The pool is not thread-safe,
+     * and must outlive its leases.
+     */
+    class UinputPool {
+
+        struct Hash {
+            std::size_t
+            operator ()(const DeviceInfo& info)
+                const noexcept;
+        };
+
+        struct Equal {
+            bool
+            operator ()(const DeviceInfo& a,
+                        const DeviceInfo& b)
+                const noexcept;
+        };
+
+        using Map = std::unordered_map<DeviceInfo, std::vector<Uinput>, Hash, Equal>;
+
+        Map idle;
+        std::size_t max_idle;
+
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+
+    public:
+
+        /// A device borrowed from the pool; it goes back when the lease ends.
+        class Lease {
+
+            friend class UinputPool;
+
+            UinputPool* pool = nullptr;
+            Map::value_type* entry = nullptr;
+            Uinput udev;
+
+            Lease(UinputPool* pool,
+                  Map::value_type* entry,
+                  Uinput&& udev)
+                noexcept;
+
+        public:
+
+            /// Create an empty lease.
+            Lease()
+                noexcept;
+
+            ~Lease()
+                noexcept;
+
+
+            Lease(Lease&& other)
+                noexcept;
+
+            Lease&
+            operator =(Lease&& other)
+                noexcept;
+
+
+            [[nodiscard]]
+            explicit
+            operator bool()
+                const noexcept;
+
+            [[nodiscard]]
+            Uinput&
+            get()
+                noexcept;
+
+            [[nodiscard]]
+            Uinput&
+            operator *()
+                noexcept;
+
+            [[nodiscard]]
+            Uinput*
+            operator ->()
+                noexcept;
+
+            /// Give the device back now; the lease becomes empty.
+            void
+            release()
+                noexcept;
+
+        }; // class Lease
+
+
+        /// @param max_idle How many idle devices to keep, per fingerprint.
+        explicit
+        UinputPool(std::size_t max_idle = 8);
+
+        ~UinputPool()
+            noexcept;
+
+
+        UinputPool(const UinputPool&) = delete;
+
+        UinputPool&
+        operator =(const UinputPool&) = delete;
+
+
+        /**
+         * @brief Get a device that looks like `dev`, reusing an idle one if possible.
+         *
+         * @throw std::system_error if a new device can't be created.
+         */
+        [[nodiscard]]
+        Lease
+        acquire(const Device& dev);
+
+        /// Same as above, from a probed device.
+        [[nodiscard]]
+        Lease
+        acquire(const DeviceInfo& info);
+
+
+        /// How many acquisitions reused an idle device.
+        [[nodiscard]]
+        std::uint64_t
+        get_hit_count()
+            const noexcept;
+
+        /// How many acquisitions created a new device.
+        [[nodiscard]]
+        std::uint64_t
+        get_miss_count()
+            const noexcept;
+
+        void
+        reset_counters()
+            noexcept;
+
+
+        /// How many devices are idle.
+        [[nodiscard]]
+        std::size_t
+        get_idle_count()
+            const noexcept;
+
+        /// Destroy all idle devices.
+        void
+        clear()
+            noexcept;
+
+    private:
+
+        // Put a device in its neutral state, and keep it if there's room.
+        void
+        give_back(Map::value_type& entry,
+                  Uinput&& udev)
+            noexcept;
+
+    }; // class UinputPool
+
+} // namespace evdev
+
+#endif
@@ -11,14 +11,37 @@
 // convenience header: includes all of libevdevxx
 
 #include "AbsInfo.hpp"
+#include "BitSet.hpp"
+#include "CancelToken.hpp"
+#include "Capabilities.hpp"
+#include "CapabilityCache.hpp"
 #include "Code.hpp"
 #include "Device.hpp"
+#include "DeviceInfo.hpp"
+#include "DeviceMonitor.hpp"
+#include "DeviceScanner.hpp"
+#include "Doorbell.hpp"
 #include "Event.hpp"
+#include "EventDispatcher.hpp"
+#include "EventFrame.hpp"
+#include "EventLoop.hpp"
+#include "EventQueue.hpp"
 #include "Grabber.hpp"
+#include "LiteDevice.hpp"
+#include "Match.hpp"
 #include "Property.hpp"
+#include "RawEvent.hpp"
+#include "RawReader.hpp"
+#include "Reactor.hpp"
+#include "ReaderThread.hpp"
+#include "Resync.hpp"
+#include "Scheduler.hpp"
 #include "SyncError.hpp"
+#include "Task.hpp"
 #include "Type.hpp"
 #include "TypeCode.hpp"
 #include "Uinput.hpp"
+#include "UinputFrame.hpp"
+#include "UinputPool.hpp"
 
 #endif
@@ -0,0 +1,310 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include <sys/ioctl.h>
+
+#include "libevdevxx/Capabilities.hpp"
+
+#include "libevdevxx/Device.hpp"
+
+#include "error.hpp"
+#include "utils.hpp"
+
+
+namespace evdev {
+
+    namespace {
+
+        // The types that EVIOCGBIT knows about; the others have no kernel bitmap.
+        constexpr std::array bit_types{
+            EV_KEY, EV_REL, EV_ABS, EV_MSC, EV_SW, EV_LED, EV_SND, EV_FF
+        };
+
+
+        bool
+        same_axis(const AbsInfo& a,
+                  const AbsInfo& b)
+            noexcept
+        {
+            return a.min == b.min
+                && a.max == b.max
+                && a.fuzz == b.fuzz
+                && a.flat == b.flat
+                && a.res == b.res;
+        }
+
+    } // namespace
+
+
+    Capabilities::Capabilities(int fd)
+    {
+        if (::ioctl(fd, EVIOCGBIT(0, types.size_bytes()), types.data()) < 0)
+            throw_sys_error(errno, "ioctl(EVIOCGBIT(0))");
+
+        for (unsigned t : bit_types) {
+            if (!types.test(t))
+                continue;
+            CodeSet& bits = codes[t];
+            if (::ioctl(fd, EVIOCGBIT(t, bits.size_bytes()), bits.data()) < 0)
+                throw_sys_error(errno, "ioctl(EVIOCGBIT(" + std::to_string(t) + "))");
+        }
+
+        // old kernels don't support EVIOCGPROP; leave it empty
+        if (::ioctl(fd, EVIOCGPROP(props.size_bytes()), props.data()) < 0 && errno != EINVAL)
+            throw_sys_error(errno, "ioctl(EVIOCGPROP)");
+
+        for (std::size_t c : codes[EV_ABS]) {
+            ::input_absinfo info;
+            if (::ioctl(fd, EVIOCGABS(c), &info) < 0)
+                throw_sys_error(errno, "ioctl(EVIOCGABS(" + std::to_string(c) + "))");
+            abs_info[c] = info;
+        }
+
+        add_implicit_codes();
+    }
+
+
+    Capabilities::Capabilities(const Device& dev)
+    {
+        const libevdev* raw = dev.data();
+
+        if (int fd = libevdev_get_fd(raw); fd >= 0) {
+            *this = Capabilities{fd};
+            return;
+        }
+
+        for (unsigned t = 0; t < EV_CNT; ++t) {
+            if (!libevdev_has_event_type(raw, t))
+                continue;
+            types.set(t);
+            int max = libevdev_event_type_get_max(t);
+            for (int c = 0; c <= max; ++c)
+                if (libevdev_has_event_code(raw, t, c))
+                    codes[t].set(c);
+        }
+
+        for (unsigned p = 0; p < INPUT_PROP_CNT; ++p)
+            if (libevdev_has_property(raw, p))
+                props.set(p);
+
+        for (std::size_t c : codes[EV_ABS])
+            if (auto info = libevdev_get_abs_info(raw, c))
+                abs_info[c] = *info;
+    }
+
+
+    void
+    Capabilities::add_implicit_codes()
+        noexcept
+    {
+        // libevdev reports all SYN codes, and the REP codes, for these types
+        if (types.test(EV_SYN))
+            for (unsigned c = 0; c <= SYN_MAX; ++c)
+                codes[EV_SYN].set(c);
+        if (types.test(EV_REP)) {
+            codes[EV_REP].set(REP_DELAY);
+            codes[EV_REP].set(REP_PERIOD);
+        }
+    }
+
+
+    bool
+    Capabilities::has(Type type)
+        const noexcept
+    {
+        return types.test(type);
+    }
+
+
+    bool
+    Capabilities::has(Type type,
+                      Code code)
+        const noexcept
+    {
+        return types.test(type) && codes[type].test(code);
+    }
+
+
+    bool
+    Capabilities::has(TypeCode tc)
+        const noexcept
+    {
+        return has(tc.type, tc.code);
+    }
+
+
+    bool
+    Capabilities::has(Property prop)
+        const noexcept
+    {
+        return props.test(prop);
+    }
+
+
+    void
+    Capabilities::enable(Type type)
+        noexcept
+    {
+        types.set(type);
+    }
+
+
+    void
+    Capabilities::enable(Type type,
+                         Code code)
+        noexcept
+    {
+        types.set(type);
+        codes[type].set(code);
+    }
+
+
+    void
+    Capabilities::enable_abs(Code code,
+                             const AbsInfo& info)
+        noexcept
+    {
+        if (code >= ABS_CNT)
+            return;
+        enable(Type::abs, code);
+        abs_info[code] = info;
+    }
+
+
+    void
+    Capabilities::disable(Type type,
+                          Code code)
+        noexcept
+    {
+        codes[type].reset(code);
+        if (type == Type::abs && code < ABS_CNT)
+            abs_info[code] = AbsInfo{};
+    }
+
+
+    void
+    Capabilities::enable(Property prop)
+        noexcept
+    {
+        props.set(prop);
+    }
+
+
+    void
+    Capabilities::disable(Property prop)
+        noexcept
+    {
+        props.reset(prop);
+    }
+
+
+    const Capabilities::TypeSet&
+    Capabilities::get_types()
+        const noexcept
+    {
+        return types;
+    }
+
+
+    const Capabilities::CodeSet&
+    Capabilities::get_codes(Type type)
+        const noexcept
+    {
+        return codes[type];
+    }
+
+
+    const Capabilities::PropertySet&
+    Capabilities::get_properties()
+        const noexcept
+    {
+        return props;
+    }
+
+
+    const AbsInfo&
+    Capabilities::get_abs_info(Code code)
+        const
+    {
+        if (code >= ABS_CNT)
+            throw std::out_of_range{"Invalid ABS code: " + std::to_string(code)};
+        return abs_info[code];
+    }
+
+
+    Capabilities
+    Capabilities::intersect(const Capabilities& other)
+        const noexcept
+    {
+        Capabilities result;
+        result.types = types & other.types;
+        result.props = props & other.props;
+        for (std::size_t t = 0; t < EV_CNT; ++t)
+            result.codes[t] = codes[t] & other.codes[t];
+        for (std::size_t c : result.codes[EV_ABS])
+            result.abs_info[c] = abs_info[c];
+        return result;
+    }
+
+
+    bool
+    Capabilities::is_superset(const Capabilities& other)
+        const noexcept
+    {
+        if (!types.is_superset(other.types) || !props.is_superset(other.props))
+            return false;
+        for (std::size_t t : other.types)
+            if (!codes[t].is_superset(other.codes[t]))
+                return false;
+        return true;
+    }
+
+
+    bool
+    Capabilities::is_subset(const Capabilities& other)
+        const noexcept
+    {
+        return other.is_superset(*this);
+    }
+
+
+    bool
+    Capabilities::operator ==(const Capabilities& other)
+        const noexcept
+    {
+        if (types != other.types || props != other.props || codes != other.codes)
+            return false;
+        for (std::size_t c : codes[EV_ABS])
+            if (!same_axis(abs_info[c], other.abs_info[c]))
+                return false;
+        return true;
+    }
+
+
+    std::size_t
+    Capabilities::hash()
+        const noexcept
+    {
+        using detail::hash_combine;
+
+        std::size_t result = hash_combine(types.hash(), props.hash());
+        for (std::size_t t : types)
+            result = hash_combine(result, codes[t].hash());
+        for (std::size_t c : codes[EV_ABS]) {
+            const AbsInfo& a = abs_info[c];
+            for (std::int32_t v : {a.min, a.max, a.fuzz, a.flat, a.res})
+                result = hash_combine(result, static_cast<std::uint32_t>(v));
+        }
+        return result;
+    }
+
+} // namespace evdev
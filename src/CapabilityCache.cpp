@@ -0,0 +1,543 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h> // close(), fsync(), getpid(), write()
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#include "libevdevxx/CapabilityCache.hpp"
+
+#include "error.hpp"
+
+
+namespace evdev {
+
+    struct CapabilityCache::IndexEntry {
+        std::uint64_t dev;
+        std::uint64_t ident;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+
+    namespace {
+
+        constexpr char magic[8] = {'E', 'V', 'X', 'X', 'C', 'A', 'P', '\0'};
+        constexpr std::uint32_t format_version = 1;
+
+        using Word = BitSet<1>::word_type;
+
+
+        struct FileHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t word_size;
+            std::uint64_t count;
+        };
+
+
+        std::uint64_t
+        fnv1a(std::string_view data,
+              std::uint64_t hash = 0xcbf29ce484222325)
+            noexcept
+        {
+            for (unsigned char c : data)
+                hash = (hash ^ c) * 0x100000001b3;
+            return hash;
+        }
+
+
+        class Writer {
+
+            std::vector<std::byte>& out;
+
+        public:
+
+            explicit
+            Writer(std::vector<std::byte>& out) :
+                out{out}
+            {}
+
+
+            void
+            put(const void* data,
+                std::size_t size)
+            {
+                auto bytes = static_cast<const std::byte*>(data);
+                out.insert(out.end(), bytes, bytes + size);
+            }
+
+
+            template<typename T>
+            void
+            put(const T& value)
+            {
+                put(&value, sizeof value);
+            }
+
+
+            void
+            put_string(const std::string& s)
+            {
+                put(static_cast<std::uint32_t>(s.size()));
+                put(s.data(), s.size());
+            }
+
+
+            void
+            put_string(const std::optional<std::string>& s)
+            {
+                put(static_cast<std::uint8_t>(s.has_value()));
+                if (s)
+                    put_string(*s);
+            }
+
+
+            // Only the words up to the last non-zero one.
+            template<std::size_t N>
+            void
+            put_bits(const BitSet<N>& bits)
+            {
+                std::uint16_t n = bits.num_words;
+                while (n > 0 && bits.data()[n - 1] == 0)
+                    --n;
+                put(n);
+                put(bits.data(), n * sizeof(Word));
+            }
+
+        }; // class Writer
+
+
+        // Reads back what Writer wrote; any overrun makes it fail, instead of throwing.
+        class Reader {
+
+            std::span<const std::byte> in;
+            std::size_t pos = 0;
+            bool ok = true;
+
+        public:
+
+            explicit
+            Reader(std::span<const std::byte> in) :
+                in{in}
+            {}
+
+
+            bool
+            get(void* data,
+                std::size_t size)
+                noexcept
+            {
+                if (!ok || size > in.size() - pos)
+                    return ok = false;
+                std::memcpy(data, in.data() + pos, size);
+                pos += size;
+                return true;
+            }
+
+
+            template<typename T>
+            T
+            get()
+                noexcept
+            {
+                T value{};
+                get(&value, sizeof value);
+                return value;
+            }
+
+
+            std::string
+            get_string()
+            {
+                auto size = get<std::uint32_t>();
+                if (!ok || size > in.size() - pos) {
+                    ok = false;
+                    return {};
+                }
+                std::string s(reinterpret_cast<const char*>(in.data() + pos), size);
+                pos += size;
+                return s;
+            }
+
+
+            std::optional<std::string>
+            get_opt_string()
+            {
+                if (!get<std::uint8_t>())
+                    return {};
+                return get_string();
+            }
+
+
+            template<std::size_t N>
+            BitSet<N>
+            get_bits()
+                noexcept
+            {
+                BitSet<N> bits;
+                auto n = get<std::uint16_t>();
+                if (n > bits.num_words)
+                    ok = false;
+                else
+                    get(bits.data(), n * sizeof(Word));
+                return bits;
+            }
+
+
+            [[nodiscard]]
+            bool
+            good()
+                const noexcept
+            {
+                return ok;
+            }
+
+        }; // class Reader
+
+
+        std::vector<std::byte>
+        encode(const DeviceInfo& info)
+        {
+            std::vector<std::byte> result;
+            Writer w{result};
+
+            w.put_string(info.name);
+            w.put_string(info.phys);
+            w.put_string(info.uniq);
+            w.put(info.bustype);
+            w.put(info.vendor);
+            w.put(info.product);
+            w.put(info.version);
+            w.put(static_cast<std::int32_t>(info.driver_version));
+
+            const Capabilities& caps = info.caps;
+            w.put_bits(caps.get_properties());
+            w.put_bits(caps.get_types());
+            for (std::size_t t : caps.get_types())
+                w.put_bits(caps.get_codes(Type(t)));
+            for (std::size_t c : caps.get_codes(Type::abs)) {
+                const AbsInfo& a = caps.get_abs_info(Code(c));
+                for (std::int32_t v : {a.min, a.max, a.fuzz, a.flat, a.res})
+                    w.put(v);
+            }
+
+            return result;
+        }
+
+
+        std::optional<DeviceInfo>
+        decode(std::span<const std::byte> data)
+        {
+            Reader r{data};
+            DeviceInfo info;
+
+            info.name = r.get_string();
+            info.phys = r.get_opt_string();
+            info.uniq = r.get_opt_string();
+            info.bustype = r.get<std::uint16_t>();
+            info.vendor = r.get<std::uint16_t>();
+            info.product = r.get<std::uint16_t>();
+            info.version = r.get<std::uint16_t>();
+            info.driver_version = r.get<std::int32_t>();
+
+            Capabilities& caps = info.caps;
+            for (std::size_t p : r.get_bits<INPUT_PROP_CNT>())
+                caps.enable(Property(p));
+            auto types = r.get_bits<EV_CNT>();
+            for (std::size_t t : types) {
+                caps.enable(Type(t));
+                for (std::size_t c : r.get_bits<KEY_CNT>())
+                    caps.enable(Type(t), Code(c));
+            }
+            if (types.test(EV_ABS)) {
+                // copied, since enable_abs() changes what's iterated over
+                const auto axes = caps.get_codes(Type::abs);
+                for (std::size_t c : axes) {
+                    AbsInfo a;
+                    a.min = r.get<std::int32_t>();
+                    a.max = r.get<std::int32_t>();
+                    a.fuzz = r.get<std::int32_t>();
+                    a.flat = r.get<std::int32_t>();
+                    a.res = r.get<std::int32_t>();
+                    caps.enable_abs(Code(c), a);
+                }
+            }
+
+            if (!r.good())
+                return {};
+            return info;
+        }
+
+
+        void
+        write_all(int fd,
+                  const void* data,
+                  std::size_t size)
+        {
+            auto bytes = static_cast<const char*>(data);
+            while (size) {
+                ssize_t w = ::write(fd, bytes, size);
+                if (w < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    throw_sys_error(errno, "write()");
+                }
+                bytes += w;
+                size -= w;
+            }
+        }
+
+    } // namespace
+
+
+    CapabilityCache::CapabilityCache(const std::filesystem::path& f) :
+        file{f}
+    {
+        remap();
+    }
+
+
+    CapabilityCache::~CapabilityCache()
+        noexcept
+    {
+        unmap();
+    }
+
+
+    void
+    CapabilityCache::unmap()
+        noexcept
+    {
+        if (map)
+            ::munmap(const_cast<std::byte*>(map), map_size);
+        map = nullptr;
+        map_size = 0;
+    }
+
+
+    void
+    CapabilityCache::remap()
+    {
+        unmap();
+
+        int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return;
+        struct ::stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(FileHeader))) {
+            void* m = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m != MAP_FAILED) {
+                map = static_cast<const std::byte*>(m);
+                map_size = st.st_size;
+            }
+        }
+        ::close(fd);
+
+        if (!map)
+            return;
+
+        FileHeader header;
+        std::memcpy(&header, map, sizeof header);
+        const std::size_t max_count = (map_size - sizeof header) / sizeof(IndexEntry);
+        if (std::memcmp(header.magic, magic, sizeof magic)
+            || header.version != format_version
+            || header.word_size != sizeof(Word)
+            || header.count > max_count)
+            unmap(); // stale or foreign; treat it as empty
+    }
+
+
+    std::span<const CapabilityCache::IndexEntry>
+    CapabilityCache::get_index()
+        const noexcept
+    {
+        if (!map)
+            return {};
+        FileHeader header;
+        std::memcpy(&header, map, sizeof header);
+        // the header size is a multiple of 8, so the index is aligned
+        return {
+            reinterpret_cast<const IndexEntry*>(map + sizeof header),
+            static_cast<std::size_t>(header.count)
+        };
+    }
+
+
+    std::optional<CapabilityCache::Key>
+    CapabilityCache::make_key(const std::filesystem::path& node)
+    {
+        struct ::stat st;
+        if (::stat(node.c_str(), &st) < 0 || !S_ISCHR(st.st_mode))
+            return {};
+
+        const std::filesystem::path sys = "/sys/dev/char/"
+            + std::to_string(major(st.st_rdev)) + ":" + std::to_string(minor(st.st_rdev));
+        std::error_code ec;
+        auto real = std::filesystem::canonical(sys, ec);
+        if (ec)
+            return {};
+
+        std::string modalias;
+        std::ifstream{sys / "device" / "modalias"} >> modalias;
+
+        std::uint64_t ident = fnv1a(real.native());
+        ident = fnv1a({"", 1}, ident);
+        ident = fnv1a(modalias, ident);
+        return Key{static_cast<std::uint64_t>(st.st_rdev), ident};
+    }
+
+
+    std::optional<DeviceInfo>
+    CapabilityCache::find(const std::filesystem::path& node)
+        const
+    {
+        auto key = make_key(node);
+        if (!key)
+            return {};
+        auto info = find(*key);
+        if (info)
+            info->path = node;
+        return info;
+    }
+
+
+    std::optional<DeviceInfo>
+    CapabilityCache::find(const Key& key)
+        const
+    {
+        if (auto it = updates.find(key.dev); it != updates.end()) {
+            if (it->second.first != key)
+                return {};
+            return decode(it->second.second);
+        }
+
+        auto index = get_index();
+        auto it = std::ranges::lower_bound(index, key.dev, {}, &IndexEntry::dev);
+        if (it == index.end() || it->dev != key.dev || it->ident != key.ident)
+            return {};
+        if (it->offset > map_size || it->size > map_size - it->offset)
+            return {};
+        return decode({map + it->offset, static_cast<std::size_t>(it->size)});
+    }
+
+
+    bool
+    CapabilityCache::insert(const DeviceInfo& info)
+    {
+        auto key = make_key(info.path);
+        if (!key)
+            return false;
+        insert(*key, info);
+        return true;
+    }
+
+
+    void
+    CapabilityCache::insert(const Key& key,
+                            const DeviceInfo& info)
+    {
+        if (info.error)
+            return;
+        updates[key.dev] = {key, encode(info)};
+    }
+
+
+    void
+    CapabilityCache::save()
+    {
+        // merge the mapped entries with the updates, sorted by dev
+        struct Record {
+            Key key;
+            std::span<const std::byte> data;
+        };
+        std::vector<Record> records;
+        for (const IndexEntry& e : get_index()) {
+            if (updates.contains(e.dev))
+                continue;
+            if (e.offset > map_size || e.size > map_size - e.offset)
+                continue;
+            records.push_back({{e.dev, e.ident},
+                               {map + e.offset, static_cast<std::size_t>(e.size)}});
+        }
+        for (const auto& [dev, update] : updates)
+            records.push_back({update.first, update.second});
+        std::ranges::sort(records, {}, [](const Record& r) { return r.key.dev; });
+
+        FileHeader header{};
+        std::memcpy(header.magic, magic, sizeof magic);
+        header.version = format_version;
+        header.word_size = sizeof(Word);
+        header.count = records.size();
+
+        std::vector<IndexEntry> index;
+        index.reserve(records.size());
+        std::uint64_t offset = sizeof header + records.size() * sizeof(IndexEntry);
+        for (const Record& r : records) {
+            index.push_back({r.key.dev, r.key.ident, offset, r.data.size()});
+            offset += r.data.size();
+        }
+
+        const std::string tmp = file.string() + ".tmp." + std::to_string(::getpid());
+        int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            throw_sys_error(errno, "open()");
+        try {
+            write_all(fd, &header, sizeof header);
+            write_all(fd, index.data(), index.size() * sizeof(IndexEntry));
+            for (const Record& r : records)
+                write_all(fd, r.data.data(), r.data.size());
+            if (::fsync(fd) < 0)
+                throw_sys_error(errno, "fsync()");
+            if (::close(fd) < 0) {
+                fd = -1;
+                throw_sys_error(errno, "close()");
+            }
+            fd = -1;
+            std::filesystem::rename(tmp, file);
+        }
+        catch (...) {
+            if (fd >= 0)
+                ::close(fd);
+            std::error_code ec;
+            std::filesystem::remove(tmp, ec);
+            throw;
+        }
+
+        updates.clear();
+        remap();
+    }
+
+
+    std::size_t
+    CapabilityCache::size()
+        const noexcept
+    {
+        std::size_t result = updates.size();
+        for (const IndexEntry& e : get_index())
+            if (!updates.contains(e.dev))
+                ++result;
+        return result;
+    }
+
+} // namespace evdev
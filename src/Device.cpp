@@ -5,6 +5,10 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
 #include <stdexcept>
 #include <string>
 
@@ -16,8 +20,12 @@
 #include <unistd.h> // close()
 #endif
 
+#include <poll.h>
+#include <sys/ioctl.h>
+
 #include "libevdevxx/Device.hpp"
 
+#include "libevdevxx/CancelToken.hpp"
 #include "libevdevxx/Event.hpp"
 #include "libevdevxx/SyncError.hpp"
 
@@ -206,11 +214,15 @@ namespace evdev {
             libevdev_free(old_raw);
         if (old_fd != -1)
             ::close(old_fd);
+        event_mask.reset();
     }
 
 
     Device::Device(Device&& other)
-        noexcept
+        noexcept :
+        event_mask{std::move(other.event_mask)},
+        frame_events{other.frame_events},
+        dropped_frame_events{other.dropped_frame_events}
     {
         acquire(other.release());
     }
@@ -223,6 +235,9 @@ namespace evdev {
         if (this != &other) {
             destroy();
             acquire(other.release());
+            event_mask = std::move(other.event_mask);
+            frame_events = other.frame_events;
+            dropped_frame_events = other.dropped_frame_events;
         }
         return *this;
     }
@@ -278,6 +293,238 @@ namespace evdev {
     }
 
 
+    struct Device::EventMask {
+        // Index 0 is the mask of types; an empty vector means nothing is masked.
+        std::array<std::vector<unsigned long>, EV_CNT> bits;
+    };
+
+
+    // The kernel reads and writes masks as arrays of unsigned long, so the byte order
+    // of a word matters.
+    constexpr unsigned long_bits = 8 * sizeof(unsigned long);
+
+
+    static
+    std::size_t
+    mask_words(unsigned bits)
+        noexcept
+    {
+        return (bits + long_bits - 1) / long_bits;
+    }
+
+
+    static
+    void
+    set_bit(std::vector<unsigned long>& bits,
+            unsigned n)
+        noexcept
+    {
+        bits[n / long_bits] |= 1ul << (n % long_bits);
+    }
+
+
+    // The types EVIOCSMASK accepts; the kernel returns EINVAL for the others.
+    constexpr std::array<std::uint16_t, 9> maskable_types{
+        EV_SYN, EV_KEY, EV_REL, EV_ABS, EV_MSC, EV_SW, EV_LED, EV_SND, EV_FF,
+    };
+
+
+    // How many bits the kernel uses for the mask of a type; same as the kernel's
+    // evdev_get_mask_cnt().
+    static
+    unsigned
+    mask_bits(Type type)
+    {
+        switch (type) {
+            case EV_SYN:
+                return EV_CNT;
+            case EV_KEY:
+                return KEY_CNT;
+            case EV_REL:
+                return REL_CNT;
+            case EV_ABS:
+                return ABS_CNT;
+            case EV_MSC:
+                return MSC_CNT;
+            case EV_SW:
+                return SW_CNT;
+            case EV_LED:
+                return LED_CNT;
+            case EV_SND:
+                return SND_CNT;
+            case EV_FF:
+                return FF_CNT;
+            default:
+                throw std::invalid_argument{"Event type can't be masked: "s + to_string(type)};
+        }
+    }
+
+
+    static
+    void
+    set_mask_ioctl(int fd,
+                   Type type,
+                   std::vector<unsigned long>& bits)
+    {
+        ::input_mask mask{};
+        mask.type = type;
+        mask.codes_size = bits.size() * sizeof(unsigned long);
+        mask.codes_ptr = reinterpret_cast<std::uintptr_t>(bits.data());
+        if (::ioctl(fd, EVIOCSMASK, &mask) < 0)
+            throw_sys_error(errno, "ioctl(EVIOCSMASK)");
+    }
+
+
+    static
+    std::vector<unsigned long>
+    get_mask_ioctl(int fd,
+                   Type type)
+    {
+        std::vector<unsigned long> bits(mask_words(mask_bits(type)));
+        ::input_mask mask{};
+        mask.type = type;
+        mask.codes_size = bits.size() * sizeof(unsigned long);
+        mask.codes_ptr = reinterpret_cast<std::uintptr_t>(bits.data());
+        if (::ioctl(fd, EVIOCGMASK, &mask) < 0)
+            throw_sys_error(errno, "ioctl(EVIOCGMASK)");
+        return bits;
+    }
+
+
+    static
+    bool
+    test_bit(const std::vector<unsigned long>& bits,
+             unsigned n)
+        noexcept
+    {
+        return n / long_bits < bits.size() && (bits[n / long_bits] >> (n % long_bits)) & 1;
+    }
+
+
+    void
+    Device::set_event_mask(Type type,
+                           std::span<const Code> codes)
+    {
+        if (type == Type::syn)
+            throw std::invalid_argument{"Use set_type_mask() to mask event types."};
+
+        const unsigned count = mask_bits(type);
+        std::vector<unsigned long> bits(mask_words(count));
+        for (Code c : codes) {
+            if (c >= count)
+                throw std::invalid_argument{"Invalid code for type "s + to_string(type)};
+            set_bit(bits, c);
+        }
+
+        set_mask_ioctl(get_fd(), type, bits);
+        if (!event_mask)
+            event_mask = std::make_unique<EventMask>();
+        event_mask->bits[type] = std::move(bits);
+    }
+
+
+    void
+    Device::set_type_mask(std::span<const Type> types)
+    {
+        std::vector<unsigned long> bits(mask_words(EV_CNT));
+        set_bit(bits, EV_SYN);
+        for (Type t : types)
+            set_bit(bits, t);
+
+        set_mask_ioctl(get_fd(), Type::syn, bits);
+        if (!event_mask)
+            event_mask = std::make_unique<EventMask>();
+        event_mask->bits[0] = std::move(bits);
+    }
+
+
+    void
+    Device::set_event_mask(std::span<const TypeCode> codes)
+    {
+        std::array<std::vector<Code>, EV_CNT> by_type;
+        std::vector<Type> types;
+        for (auto [type, code] : codes) {
+            if (by_type[type].empty())
+                types.push_back(type);
+            by_type[type].push_back(code);
+        }
+
+        set_type_mask(types);
+        for (Type t : types)
+            if (t != Type::syn)
+                set_event_mask(t, by_type[t]);
+    }
+
+
+    void
+    Device::clear_event_mask()
+    {
+        // If an ioctl fails, some masks may be left, but they no longer hide resync
+        // deltas.
+        event_mask.reset();
+        for (std::uint16_t t : maskable_types) {
+            Type type{t};
+            std::vector<unsigned long> bits(mask_words(mask_bits(type)), ~0ul);
+            set_mask_ioctl(get_fd(), type, bits);
+        }
+    }
+
+
+    std::vector<Code>
+    Device::get_event_mask(Type type)
+        const
+    {
+        if (type == Type::syn)
+            throw std::invalid_argument{"Use get_type_mask() to query event types."};
+
+        auto bits = get_mask_ioctl(get_fd(), type);
+        std::vector<Code> result;
+        const unsigned count = mask_bits(type);
+        for (unsigned c = 0; c < count; ++c)
+            if (test_bit(bits, c))
+                result.push_back(Code{static_cast<Code::value_type>(c)});
+        return result;
+    }
+
+
+    std::vector<Type>
+    Device::get_type_mask()
+        const
+    {
+        auto bits = get_mask_ioctl(get_fd(), Type::syn);
+        std::vector<Type> result;
+        for (std::uint16_t t = 0; t < EV_CNT; ++t)
+            if (test_bit(bits, t))
+                result.push_back(Type{t});
+        return result;
+    }
+
+
+    bool
+    Device::is_masked(std::uint16_t type,
+                      std::uint16_t code)
+        const noexcept
+    {
+        if (!event_mask || type == EV_SYN || type >= EV_CNT)
+            return false;
+        const auto& types = event_mask->bits[0];
+        if (!types.empty() && !test_bit(types, type))
+            return true;
+        const auto& codes = event_mask->bits[type];
+        if (codes.empty() || code / long_bits >= codes.size())
+            return false;
+        return !test_bit(codes, code);
+    }
+
+
+    bool
+    Device::is_masked(TypeCode tc)
+        const noexcept
+    {
+        return is_masked(tc.type, tc.code);
+    }
+
+
     void
     Device::set_fd(int fd)
     {
@@ -942,15 +1189,200 @@ namespace evdev {
         noexcept
     {
         ::input_event raw_event;
-        int val = libevdev_next_event(raw,
-                                        static_cast<unsigned>(flags),
-                                        &raw_event);
-        if (val >= 0)
+        int val;
+        do
+            val = libevdev_next_event(raw,
+                                      static_cast<unsigned>(flags),
+                                      &raw_event);
+        while ((flags & ReadFlag::resync)
+               && val == LIBEVDEV_READ_STATUS_SYNC
+               && is_masked(raw_event.type, raw_event.code));
+        if (val >= 0) {
+            track_frame(raw_event);
             event = raw_event;
+        }
         return ReadStatus{val};
     }
 
 
+    template<typename T>
+    std::size_t
+    Device::read_batch_impl(std::span<T> events,
+                            ReadStatus& status,
+                            ReadFlag flags)
+        noexcept
+    {
+        const bool resyncing = flags & ReadFlag::resync;
+        status = ReadStatus::success;
+        std::size_t count = 0;
+        ::input_event raw_event;
+        while (count < events.size()) {
+            int val = libevdev_next_event(raw,
+                                          static_cast<unsigned>(flags),
+                                          &raw_event);
+            status = ReadStatus{val};
+            if (val < 0)
+                break;
+            // the kernel filters masked events, but not libevdev's resync deltas
+            if (resyncing && is_masked(raw_event.type, raw_event.code))
+                continue;
+            track_frame(raw_event);
+            events[count++] = raw_event;
+            if (val == LIBEVDEV_READ_STATUS_SYNC && !resyncing)
+                break;
+            // only block for the first event
+            flags &= ~ReadFlag::blocking;
+        }
+        return count;
+    }
+
+
+    std::size_t
+    Device::read_batch(std::span<Event> events,
+                       ReadStatus& status,
+                       ReadFlag flags)
+        noexcept
+    {
+        return read_batch_impl(events, status, flags);
+    }
+
+
+    std::size_t
+    Device::read_batch(std::span<::input_event> events,
+                       ReadStatus& status,
+                       ReadFlag flags)
+        noexcept
+    {
+        return read_batch_impl(events, status, flags);
+    }
+
+
+    std::size_t
+    Device::read_batch(std::span<RawEvent> events,
+                       ReadStatus& status,
+                       ReadFlag flags)
+        noexcept
+    {
+        return read_batch(as_input_events(events), status, flags);
+    }
+
+
+    ReadStatus
+    Device::read_frame(EventFrame& frame,
+                       ReadFlag flags)
+    {
+        if (frame.is_complete() || !frame.is_valid())
+            frame.clear();
+
+        const bool resyncing = flags & ReadFlag::resync;
+        ::input_event raw_event;
+        for (;;) {
+            int val = libevdev_next_event(raw,
+                                          static_cast<unsigned>(flags),
+                                          &raw_event);
+            if (val < 0)
+                return ReadStatus{val};
+            if (resyncing && is_masked(raw_event.type, raw_event.code))
+                continue;
+            track_frame(raw_event);
+            frame.push_back(raw_event);
+            if (val == LIBEVDEV_READ_STATUS_SYNC && !resyncing) {
+                frame.set_valid(false);
+                return ReadStatus::dropped;
+            }
+            if (raw_event.type == EV_SYN && raw_event.code == SYN_REPORT) {
+                frame.set_complete();
+                // in resync mode, libevdev reports every delta as a sync event
+                return ReadStatus::success;
+            }
+        }
+    }
+
+
+    // Wait with ppoll() until the device is readable, then read; a negative cancel_fd
+    // is ignored by ppoll().
+    static
+    ReadStatus
+    read_for_helper(Device& dev,
+                    Event& event,
+                    std::chrono::nanoseconds timeout,
+                    int cancel_fd,
+                    ReadFlag flags)
+        noexcept
+    {
+        // Resync events come from libevdev's state, there's nothing to wait for.
+        if (flags & ReadFlag::resync)
+            return dev.read(event, flags);
+
+        using clock = std::chrono::steady_clock;
+        // a huge timeout means no deadline, instead of overflowing
+        const auto now = clock::now();
+        const auto deadline = timeout < clock::time_point::max() - now
+            ? now + std::chrono::duration_cast<clock::duration>(timeout)
+            : clock::time_point::max();
+
+        ::pollfd fds[2] = {
+            { dev.get_fd(), POLLIN, 0 },
+            { cancel_fd,    POLLIN, 0 },
+        };
+
+        for (;;) {
+            // Events may be already queued inside libevdev, even if the fd is empty.
+            int pending = libevdev_has_event_pending(dev.data());
+            if (pending < 0)
+                return ReadStatus{pending};
+            if (pending > 0) {
+                ReadStatus status = dev.read(event, flags);
+                if (status != ReadStatus::again)
+                    return status;
+            }
+
+            auto remaining = deadline - clock::now();
+            if (remaining <= clock::duration::zero())
+                return ReadStatus::timeout;
+
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining);
+            ::timespec ts{};
+            ts.tv_sec = ns.count() / 1'000'000'000;
+            ts.tv_nsec = ns.count() % 1'000'000'000;
+
+            int r = ::ppoll(fds, 2, &ts, nullptr);
+            if (r < 0) {
+                if (errno == EINTR)
+                    continue;
+                return ReadStatus{-errno};
+            }
+            if (fds[1].revents)
+                return ReadStatus::canceled;
+            if (r == 0)
+                return ReadStatus::timeout;
+        }
+    }
+
+
+    ReadStatus
+    Device::read_for(Event& event,
+                     std::chrono::nanoseconds timeout,
+                     ReadFlag flags)
+        noexcept
+    {
+        return read_for_helper(*this, event, timeout, -1, flags);
+    }
+
+
+    ReadStatus
+    Device::read_for(Event& event,
+                     std::chrono::nanoseconds timeout,
+                     const Doorbell& token,
+                     ReadFlag flags)
+        noexcept
+    {
+        if (token.is_rung())
+            return ReadStatus::canceled;
+        return read_for_helper(*this, event, timeout, token.get_fd(), flags);
+    }
+
+
     bool
     Device::has_pending()
     {
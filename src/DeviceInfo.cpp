@@ -0,0 +1,91 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <new>
+
+#include "libevdevxx/DeviceInfo.hpp"
+
+#include "libevdevxx/LiteDevice.hpp"
+
+
+namespace evdev {
+
+    DeviceInfo
+    DeviceInfo::probe(const std::filesystem::path& path)
+    {
+        DeviceInfo info;
+        info.path = path;
+
+        try {
+            const LiteDevice dev{path, O_RDONLY | O_NONBLOCK};
+            info.name = dev.get_name();
+            info.phys = dev.get_phys();
+            info.uniq = dev.get_uniq();
+            info.bustype = dev.get_bustype();
+            info.vendor = dev.get_vendor();
+            info.product = dev.get_product();
+            info.version = dev.get_version();
+            info.driver_version = dev.get_driver_version();
+            info.caps = dev.get_capabilities();
+        }
+        catch (std::system_error& e) {
+            info.error = e.code();
+        }
+        catch (std::bad_alloc&) {
+            info.error = std::make_error_code(std::errc::not_enough_memory);
+        }
+
+        return info;
+    }
+
+
+    DeviceInfo
+    DeviceInfo::fingerprint()
+        const
+    {
+        DeviceInfo result;
+        result.name = name;
+        result.phys = phys;
+        result.bustype = bustype;
+        result.vendor = vendor;
+        result.product = product;
+        result.version = version;
+        result.caps = caps;
+        return result;
+    }
+
+
+    DeviceInfo
+    DeviceInfo::fingerprint(const Device& dev)
+    {
+        DeviceInfo result;
+        result.name = dev.get_name();
+        result.phys = dev.get_phys();
+        result.bustype = dev.get_bustype();
+        result.vendor = dev.get_vendor();
+        result.product = dev.get_product();
+        result.version = dev.get_version();
+        result.caps = Capabilities{dev};
+        return result;
+    }
+
+
+    DeviceInfo::operator bool()
+        const noexcept
+    {
+        return !error;
+    }
+
+
+    Device
+    DeviceInfo::open(int flags)
+        const
+    {
+        return Device{path, flags};
+    }
+
+} // namespace evdev
@@ -0,0 +1,330 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h> // close(), read()
+#endif
+
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/timerfd.h>
+
+#include "libevdevxx/DeviceMonitor.hpp"
+
+#include "error.hpp"
+#include "utils.hpp"
+
+
+using std::chrono::steady_clock;
+
+
+namespace evdev {
+
+    namespace {
+
+        bool
+        is_permission_error(const std::error_code& error)
+            noexcept
+        {
+            return error == std::errc::permission_denied
+                || error == std::errc::operation_not_permitted;
+        }
+
+
+        // The node is already gone.
+        bool
+        is_gone_error(const std::error_code& error)
+            noexcept
+        {
+            return error == std::errc::no_such_file_or_directory
+                || error == std::errc::no_such_device
+                || error == std::errc::no_such_device_or_address;
+        }
+
+    } // namespace
+
+
+    DeviceMonitor::DeviceMonitor(const std::filesystem::path& d,
+                                 std::chrono::milliseconds retry,
+                                 std::chrono::milliseconds settle,
+                                 std::chrono::milliseconds probe) :
+        dir{d},
+        retry_interval{retry},
+        settle_timeout{settle},
+        scanner{0, probe}
+    {
+        try {
+            epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+            if (epoll_fd < 0)
+                throw_sys_error(errno, "epoll_create1()");
+
+            inotify_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (inotify_fd < 0)
+                throw_sys_error(errno, "inotify_init1()");
+
+            const std::uint32_t mask = IN_CREATE | IN_ATTRIB | IN_DELETE
+                | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+            if (::inotify_add_watch(inotify_fd, dir.c_str(), mask) < 0)
+                throw_sys_error(errno, "inotify_add_watch()");
+
+            timer_fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+            if (timer_fd < 0)
+                throw_sys_error(errno, "timerfd_create()");
+
+            for (int fd : {inotify_fd, timer_fd}) {
+                ::epoll_event ev{};
+                ev.events = EPOLLIN;
+                ev.data.fd = fd;
+                if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+                    throw_sys_error(errno, "epoll_ctl()");
+            }
+        }
+        catch (...) {
+            close_all();
+            throw;
+        }
+    }
+
+
+    DeviceMonitor::~DeviceMonitor()
+        noexcept
+    {
+        close_all();
+    }
+
+
+    void
+    DeviceMonitor::close_all()
+        noexcept
+    {
+        for (int fd : {timer_fd, inotify_fd, epoll_fd})
+            if (fd >= 0)
+                ::close(fd);
+        timer_fd = inotify_fd = epoll_fd = -1;
+    }
+
+
+    void
+    DeviceMonitor::on_added(AddedHandler handler)
+    {
+        added = std::move(handler);
+    }
+
+
+    void
+    DeviceMonitor::on_removed(RemovedHandler handler)
+    {
+        removed = std::move(handler);
+    }
+
+
+    void
+    DeviceMonitor::add_existing()
+    {
+        const auto paths = DeviceScanner::list(dir);
+        const auto infos = scanner.scan(paths);
+        for (const DeviceInfo& info : infos) {
+            const std::string name = info.path.filename().string();
+            if (present.contains(name) || pending.contains(name))
+                continue;
+            if (is_gone_error(info.error))
+                continue;
+            if (is_permission_error(info.error)) {
+                // let it settle, like a new node
+                try_add(name);
+                continue;
+            }
+            present.insert(name);
+            if (added)
+                added(info);
+        }
+        arm_timer();
+    }
+
+
+    void
+    DeviceMonitor::try_add(const std::string& name)
+    {
+        try_add(std::vector{name});
+    }
+
+
+    void
+    DeviceMonitor::try_add(const std::vector<std::string>& names)
+    {
+        std::vector<std::filesystem::path> paths;
+        for (const auto& name : names)
+            if (!present.contains(name))
+                paths.push_back(dir / name);
+        if (paths.empty())
+            return;
+
+        // a hung driver costs at most the probe timeout
+        const auto infos = scanner.scan(paths);
+        const auto now = steady_clock::now();
+
+        for (const DeviceInfo& info : infos) {
+            const std::string name = info.path.filename().string();
+
+            if (is_gone_error(info.error)) {
+                pending.erase(name);
+                continue;
+            }
+
+            if (is_permission_error(info.error)) {
+                auto [it, inserted] = pending.try_emplace(name, Pending{now, now});
+                if (now - it->second.first_seen < settle_timeout) {
+                    it->second.next_try = now + retry_interval;
+                    continue;
+                }
+                // gave up; report it anyway
+            }
+
+            pending.erase(name);
+            present.insert(name);
+            if (added)
+                added(info);
+        }
+    }
+
+
+    void
+    DeviceMonitor::handle_removal(const std::string& name)
+    {
+        pending.erase(name);
+        if (present.erase(name) && removed)
+            removed(dir / name);
+    }
+
+
+    void
+    DeviceMonitor::rescan()
+    {
+        // some notifications were lost, so compare against the directory
+        std::set<std::string> current;
+        for (const auto& path : DeviceScanner::list(dir))
+            current.insert(path.filename().string());
+
+        std::vector<std::string> gone;
+        for (const auto& name : present)
+            if (!current.contains(name))
+                gone.push_back(name);
+        for (const auto& name : gone)
+            handle_removal(name);
+
+        try_add(std::vector(current.begin(), current.end()));
+    }
+
+
+    void
+    DeviceMonitor::retry_pending()
+    {
+        const auto now = steady_clock::now();
+        std::vector<std::string> due;
+        for (const auto& [name, p] : pending)
+            if (p.next_try <= now)
+                due.push_back(name);
+        try_add(due);
+    }
+
+
+    void
+    DeviceMonitor::arm_timer()
+    {
+        ::itimerspec spec{};
+        if (!pending.empty()) {
+            auto next = pending.begin()->second.next_try;
+            for (const auto& [name, p] : pending)
+                next = std::min(next, p.next_try);
+            auto delay = std::max(next - steady_clock::now(),
+                                  steady_clock::duration{std::chrono::microseconds{1}});
+            auto sec = std::chrono::duration_cast<std::chrono::seconds>(delay);
+            auto nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(delay - sec);
+            spec.it_value.tv_sec = sec.count();
+            spec.it_value.tv_nsec = nsec.count();
+        }
+        // a zero value disarms it
+        if (::timerfd_settime(timer_fd, 0, &spec, nullptr) < 0)
+            throw_sys_error(errno, "timerfd_settime()");
+    }
+
+
+    void
+    DeviceMonitor::process()
+    {
+        std::uint64_t expirations;
+        if (::read(timer_fd, &expirations, sizeof expirations) < 0 && errno != EAGAIN)
+            throw_sys_error(errno, "read()");
+
+        alignas(::inotify_event) std::array<char, 4096> buf;
+        for (;;) {
+            ssize_t len = ::read(inotify_fd, buf.data(), buf.size());
+            if (len < 0) {
+                if (errno == EAGAIN)
+                    break;
+                if (errno == EINTR)
+                    continue;
+                throw_sys_error(errno, "read()");
+            }
+
+            for (ssize_t i = 0; i < len;) {
+                const auto* event = reinterpret_cast<const ::inotify_event*>(buf.data() + i);
+                i += sizeof(::inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    rescan();
+                    continue;
+                }
+                if (!event->len)
+                    continue;
+
+                const std::string name = event->name;
+                if (!detail::parse_event_node(name))
+                    continue;
+
+                if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+                    handle_removal(name);
+                else if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                    try_add(name);
+                else if ((event->mask & IN_ATTRIB) && pending.contains(name))
+                    try_add(name); // permissions changed, try again now
+            }
+        }
+
+        retry_pending();
+        arm_timer();
+    }
+
+
+    int
+    DeviceMonitor::get_fd()
+        const noexcept
+    {
+        return epoll_fd;
+    }
+
+
+    std::vector<std::filesystem::path>
+    DeviceMonitor::get_devices()
+        const
+    {
+        std::vector<std::filesystem::path> result;
+        result.reserve(present.size());
+        for (const auto& name : present)
+            result.push_back(dir / name);
+        return result;
+    }
+
+} // namespace evdev
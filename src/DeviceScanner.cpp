@@ -0,0 +1,249 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "libevdevxx/DeviceScanner.hpp"
+
+#include "utils.hpp"
+
+
+using std::chrono::steady_clock;
+
+
+namespace evdev {
+
+    namespace {
+
+        constexpr std::size_t no_job = std::numeric_limits<std::size_t>::max();
+
+
+        // Shared with the workers; a worker stuck in a probe may outlive the scan.
+        struct ScanState {
+
+            struct Worker {
+                std::thread thread;
+                std::size_t job = no_job;
+                steady_clock::time_point started;
+                bool abandoned = false;
+            };
+
+            std::mutex mutex;
+            std::condition_variable done;
+            std::vector<std::filesystem::path> paths;
+            std::vector<DeviceInfo> results;
+            std::vector<Worker> workers;
+            std::size_t next = 0;
+            std::size_t remaining = 0;
+
+        };
+
+
+        void
+        work(std::shared_ptr<ScanState> state,
+             std::size_t w)
+        {
+            std::unique_lock lock{state->mutex};
+            while (state->next < state->paths.size()) {
+                const std::size_t job = state->next++;
+                state->workers[w].job = job;
+                state->workers[w].started = steady_clock::now();
+                lock.unlock();
+
+                DeviceInfo info = DeviceInfo::probe(state->paths[job]);
+
+                lock.lock();
+                if (state->workers[w].abandoned)
+                    return; // timed out; a replacement took over
+                state->workers[w].job = no_job;
+                state->results[job] = std::move(info);
+                if (--state->remaining == 0)
+                    state->done.notify_all();
+            }
+        }
+
+
+        // Start a worker; the caller must hold the lock.
+        bool
+        spawn(const std::shared_ptr<ScanState>& state)
+        {
+            const std::size_t w = state->workers.size();
+            state->workers.emplace_back();
+            try {
+                state->workers[w].thread = std::thread{work, state, w};
+                return true;
+            }
+            catch (std::system_error&) {
+                state->workers.pop_back();
+                return false;
+            }
+        }
+
+
+        // Fail the jobs nobody will run, because no worker could be started.
+        void
+        fail_unstarted(ScanState& state)
+        {
+            for (; state.next < state.paths.size(); ++state.next) {
+                DeviceInfo& info = state.results[state.next];
+                info.path = state.paths[state.next];
+                info.error = std::make_error_code(std::errc::resource_unavailable_try_again);
+                --state.remaining;
+            }
+        }
+
+    } // namespace
+
+
+    DeviceScanner::DeviceScanner(std::size_t threads,
+                                 std::chrono::milliseconds t)
+        noexcept :
+        max_threads{threads ? threads : std::max(1u, std::thread::hardware_concurrency())},
+        timeout{t}
+    {}
+
+
+    std::vector<std::filesystem::path>
+    DeviceScanner::list(const std::filesystem::path& dir)
+    {
+        std::vector<std::pair<unsigned, std::filesystem::path>> found;
+        for (auto& entry : std::filesystem::directory_iterator{dir}) {
+            if (auto n = detail::parse_event_node(entry.path().filename().string()))
+                found.emplace_back(*n, entry.path());
+        }
+
+        std::ranges::sort(found);
+        std::vector<std::filesystem::path> result;
+        result.reserve(found.size());
+        for (auto& [n, path] : found)
+            result.push_back(std::move(path));
+        return result;
+    }
+
+
+    std::vector<DeviceInfo>
+    DeviceScanner::scan()
+        const
+    {
+        return scan(list());
+    }
+
+
+    std::vector<DeviceInfo>
+    DeviceScanner::scan(std::span<const std::filesystem::path> paths)
+        const
+    {
+        if (paths.empty())
+            return {};
+
+        auto state = std::make_shared<ScanState>();
+        state->paths.assign(paths.begin(), paths.end());
+        state->results.resize(paths.size());
+        state->remaining = paths.size();
+
+        std::unique_lock lock{state->mutex};
+
+        // the vector must not reallocate while workers index into it
+        const std::size_t num_threads = std::min(max_threads, paths.size());
+        state->workers.reserve(paths.size() + num_threads);
+        std::size_t live = 0;
+        for (std::size_t i = 0; i < num_threads; ++i)
+            live += spawn(state);
+
+        while (state->remaining) {
+            auto now = steady_clock::now();
+            auto wake_up = steady_clock::time_point::max();
+            for (std::size_t w = 0; w < state->workers.size(); ++w) {
+                auto& worker = state->workers[w];
+                if (worker.abandoned || worker.job == no_job)
+                    continue;
+                auto deadline = worker.started + timeout;
+                if (deadline > now) {
+                    wake_up = std::min(wake_up, deadline);
+                    continue;
+                }
+                DeviceInfo& info = state->results[worker.job];
+                info.path = state->paths[worker.job];
+                info.error = std::make_error_code(std::errc::timed_out);
+                worker.abandoned = true;
+                --live;
+                --state->remaining;
+                if (state->next < state->paths.size())
+                    live += spawn(state);
+            }
+            if (!live)
+                fail_unstarted(*state);
+            if (!state->remaining)
+                break;
+            if (wake_up == steady_clock::time_point::max())
+                state->done.wait(lock);
+            else
+                state->done.wait_until(lock, wake_up);
+        }
+
+        // Abandoned workers may still be stuck in a probe; they only touch the shared
+        // state, so they're detached, not joined.
+        std::vector<DeviceInfo> results = std::move(state->results);
+        std::vector<std::pair<std::thread, bool>> threads;
+        for (auto& worker : state->workers)
+            threads.emplace_back(std::move(worker.thread), worker.abandoned);
+        lock.unlock();
+
+        for (auto& [thread, abandoned] : threads) {
+            if (abandoned)
+                thread.detach();
+            else
+                thread.join();
+        }
+
+        return results;
+    }
+
+
+    std::vector<DeviceInfo>
+    DeviceScanner::scan(std::span<const std::filesystem::path> paths,
+                        CapabilityCache& cache)
+        const
+    {
+        std::vector<DeviceInfo> results(paths.size());
+        std::vector<std::optional<CapabilityCache::Key>> keys(paths.size());
+        std::vector<std::filesystem::path> misses;
+        std::vector<std::size_t> miss_index;
+
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            keys[i] = CapabilityCache::make_key(paths[i]);
+            if (keys[i]) {
+                if (auto info = cache.find(*keys[i])) {
+                    results[i] = std::move(*info);
+                    results[i].path = paths[i];
+                    continue;
+                }
+            }
+            misses.push_back(paths[i]);
+            miss_index.push_back(i);
+        }
+
+        auto probed = scan(misses);
+        for (std::size_t j = 0; j < probed.size(); ++j) {
+            const std::size_t i = miss_index[j];
+            if (keys[i])
+                cache.insert(*keys[i], probed[j]);
+            results[i] = std::move(probed[j]);
+        }
+
+        return results;
+    }
+
+} // namespace evdev
@@ -0,0 +1,94 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cerrno>
+#include <cstdint>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h> // close(), read(), write()
+#endif
+
+#include <poll.h>
+#include <sys/eventfd.h>
+
+#include "libevdevxx/Doorbell.hpp"
+
+#include "error.hpp"
+
+
+namespace evdev {
+
+    Doorbell::Doorbell()
+    {
+        fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd < 0)
+            throw_sys_error(errno, "eventfd()");
+    }
+
+
+    Doorbell::~Doorbell()
+        noexcept
+    {
+        ::close(fd);
+    }
+
+
+    void
+    Doorbell::ring()
+        noexcept
+    {
+        rung = true;
+        std::uint64_t one = 1;
+        [[maybe_unused]]
+        auto r = ::write(fd, &one, sizeof one);
+    }
+
+
+    bool
+    Doorbell::wait(std::optional<std::chrono::milliseconds> timeout)
+        noexcept
+    {
+        ::pollfd pfd{ fd, POLLIN, 0 };
+        int ms = timeout ? static_cast<int>(timeout->count()) : -1;
+        if (::poll(&pfd, 1, ms) <= 0)
+            return false;
+        clear();
+        return true;
+    }
+
+
+    bool
+    Doorbell::is_rung()
+        const noexcept
+    {
+        return rung.load();
+    }
+
+
+    void
+    Doorbell::clear()
+        noexcept
+    {
+        rung = false;
+        std::uint64_t count;
+        [[maybe_unused]]
+        auto r = ::read(fd, &count, sizeof count);
+    }
+
+
+    int
+    Doorbell::get_fd()
+        const noexcept
+    {
+        return fd;
+    }
+
+} // namespace evdev
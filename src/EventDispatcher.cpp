@@ -0,0 +1,186 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+
+#include "libevdevxx/EventDispatcher.hpp"
+
+
+using namespace std::literals;
+
+
+namespace evdev {
+
+    EventDispatcher::EventDispatcher() :
+        handlers(1)
+    {
+        std::uint32_t total = 0;
+        for (unsigned t = 0; t < EV_CNT; ++t) {
+            offsets[t] = total;
+            // types without codes have a negative maximum
+            int max = libevdev_event_type_get_max(t);
+            if (max >= 0)
+                total += max + 1;
+        }
+        offsets[EV_CNT] = total;
+        slots.resize(total, 0);
+    }
+
+
+    std::uint16_t
+    EventDispatcher::store(Handler handler)
+    {
+        std::vector<bool> used(handlers.size());
+        for (std::uint16_t index : slots)
+            used[index] = true;
+        for (std::size_t i = 1; i < handlers.size(); ++i) {
+            if (!used[i]) {
+                handlers[i] = std::move(handler);
+                return static_cast<std::uint16_t>(i);
+            }
+        }
+
+        if (handlers.size() > std::numeric_limits<std::uint16_t>::max())
+            throw std::length_error{"Too many handlers in EventDispatcher."};
+        handlers.push_back(std::move(handler));
+        return static_cast<std::uint16_t>(handlers.size() - 1);
+    }
+
+
+    void
+    EventDispatcher::check_idle()
+        const
+    {
+        if (dispatching)
+            throw std::logic_error{"EventDispatcher modified while dispatching."};
+    }
+
+
+    void
+    EventDispatcher::check_type(Type type)
+        const
+    {
+        if (type >= EV_CNT)
+            throw std::invalid_argument{"Invalid type "s + to_string(type)};
+    }
+
+
+    void
+    EventDispatcher::check_range(Type type,
+                                 Code first,
+                                 Code last)
+        const
+    {
+        check_type(type);
+        if (first > last || offsets[type] + last >= offsets[type + 1])
+            throw std::invalid_argument{"Invalid code range for type "s + to_string(type)};
+    }
+
+
+    void
+    EventDispatcher::fill(Type type,
+                          Code first,
+                          Code last,
+                          std::uint16_t index)
+        noexcept
+    {
+        std::fill(slots.begin() + offsets[type] + first,
+                  slots.begin() + offsets[type] + last + 1,
+                  index);
+    }
+
+
+    void
+    EventDispatcher::on(TypeCode tc,
+                        Handler handler)
+    {
+        on(tc.type, tc.code, tc.code, std::move(handler));
+    }
+
+
+    void
+    EventDispatcher::on(Type type,
+                        Code first,
+                        Code last,
+                        Handler handler)
+    {
+        check_idle();
+        check_range(type, first, last);
+        fill(type, first, last, store(std::move(handler)));
+    }
+
+
+    void
+    EventDispatcher::on(Type type,
+                        Handler handler)
+    {
+        check_type(type);
+        if (offsets[type] == offsets[type + 1])
+            throw std::invalid_argument{"Type has no codes: "s + to_string(type)};
+        on(type, Code{0}, Code::max(type), std::move(handler));
+    }
+
+
+    void
+    EventDispatcher::set_fallback(Handler handler)
+    {
+        check_idle();
+        handlers[0] = std::move(handler);
+    }
+
+
+    void
+    EventDispatcher::remove(TypeCode tc)
+    {
+        check_idle();
+        check_range(tc.type, tc.code, tc.code);
+        fill(tc.type, tc.code, tc.code, 0);
+    }
+
+
+    void
+    EventDispatcher::remove(Type type)
+    {
+        check_idle();
+        check_type(type);
+        std::fill(slots.begin() + offsets[type],
+                  slots.begin() + offsets[type + 1],
+                  0);
+    }
+
+
+    void
+    EventDispatcher::clear()
+        noexcept
+    {
+        assert(!dispatching);
+        std::fill(slots.begin(), slots.end(), 0);
+        handlers.resize(1);
+        handlers[0] = nullptr;
+    }
+
+
+    void
+    EventDispatcher::dispatch(std::span<const Event> events)
+        const
+    {
+        for (const Event& e : events)
+            dispatch(e);
+    }
+
+
+    void
+    EventDispatcher::dispatch(const EventFrame& frame)
+        const
+    {
+        dispatch(frame.events());
+    }
+
+} // namespace evdev
@@ -0,0 +1,41 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "libevdevxx/EventFrame.hpp"
+
+
+namespace evdev {
+
+    void
+    EventFrame::clear()
+        noexcept
+    {
+        // clear() on a vector does not release its capacity
+        spill.clear();
+        spilled = false;
+        count = 0;
+        valid = true;
+        complete = false;
+    }
+
+
+    void
+    EventFrame::push_back(const Event& event)
+    {
+        if (!spilled) {
+            if (count < inline_capacity) {
+                inline_storage[count++] = event;
+                return;
+            }
+            spill.assign(inline_storage.begin(), inline_storage.end());
+            spilled = true;
+        }
+        spill.push_back(event);
+        ++count;
+    }
+
+} // namespace evdev
@@ -0,0 +1,955 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <stdexcept>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h> // close(), read()
+#endif
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+
+#ifdef HAVE_LIBURING
+#include <poll.h>
+#include <liburing.h>
+#endif
+
+#include "libevdevxx/EventLoop.hpp"
+
+#include "error.hpp"
+#include "track_state.hpp"
+
+
+using std::logic_error;
+using std::runtime_error;
+
+
+namespace evdev {
+
+    namespace detail {
+
+        struct Uring {
+#ifdef HAVE_LIBURING
+            ::io_uring ring;
+#endif
+        };
+
+    } // namespace detail
+
+
+    EventLoop::EventLoop(std::size_t batch_size) :
+        EventLoop{Backend::epoll, batch_size}
+    {}
+
+
+    EventLoop::EventLoop(Backend backend,
+                         std::size_t batch_size) :
+        buffer(batch_size)
+    {
+        if (batch_size == 0)
+            throw logic_error{"EventLoop batch size must not be zero."};
+
+        epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0)
+            throw_sys_error(errno, "epoll_create1()");
+
+        wakeup_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeup_fd < 0) {
+            int e = errno;
+            ::close(epoll_fd);
+            throw_sys_error(e, "eventfd()");
+        }
+
+        ::epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = wakeup_fd;
+        if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wakeup_fd, &ev) < 0) {
+            int e = errno;
+            ::close(wakeup_fd);
+            ::close(epoll_fd);
+            throw_sys_error(e, "epoll_ctl()");
+        }
+
+        if (backend == Backend::io_uring && is_supported(backend)) {
+            try {
+                uring_init();
+            }
+            catch (...) {
+                ::close(wakeup_fd);
+                ::close(epoll_fd);
+                throw;
+            }
+        }
+    }
+
+
+    EventLoop::~EventLoop()
+        noexcept
+    {
+        if (uring)
+            uring_destroy();
+
+        for (auto& [fd, entry] : entries) {
+            switch (entry->kind) {
+                case Kind::signal:
+                    {
+                        sigset_t mask;
+                        sigemptyset(&mask);
+                        sigaddset(&mask, entry->signo);
+                        ::pthread_sigmask(SIG_UNBLOCK, &mask, nullptr);
+                    }
+                    ::close(fd);
+                    break;
+                case Kind::timer:
+                    ::close(fd);
+                    break;
+                default:
+                    ;
+            }
+        }
+        ::close(wakeup_fd);
+        ::close(epoll_fd);
+    }
+
+
+    bool
+    EventLoop::is_supported(Backend backend)
+        noexcept
+    {
+        switch (backend) {
+            case Backend::epoll:
+                return true;
+            case Backend::io_uring:
+#ifdef HAVE_LIBURING
+                {
+                    ::io_uring ring;
+                    if (::io_uring_queue_init(2, &ring, 0) < 0)
+                        return false;
+                    ::io_uring_queue_exit(&ring);
+                    return true;
+                }
+#else
+                return false;
+#endif
+        }
+        return false;
+    }
+
+
+    EventLoop::Backend
+    EventLoop::get_backend()
+        const noexcept
+    {
+        return uring ? Backend::io_uring : Backend::epoll;
+    }
+
+
+    void
+    EventLoop::insert(int fd,
+                      std::uint32_t events,
+                      std::shared_ptr<Entry> entry)
+    {
+        if (entries.contains(fd))
+            throw logic_error{"File descriptor is already in the EventLoop."};
+
+        entry->fd = fd;
+        entry->events = events;
+
+        if (uring) {
+            if (entry->kind == Kind::device)
+                entry->raw_buffer.resize(buffer.size());
+            Entry& e = *entry;
+            entries.emplace(fd, std::move(entry));
+            try {
+                uring_arm(e);
+            }
+            catch (...) {
+                entries.erase(fd);
+                throw;
+            }
+            return;
+        }
+
+        ::epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+            throw_sys_error(errno, "epoll_ctl()");
+
+        entries.emplace(fd, std::move(entry));
+    }
+
+
+    void
+    EventLoop::add(Device& dev,
+                   DeviceHandler handler,
+                   ErrorHandler on_error)
+    {
+        auto entry = std::make_shared<Entry>();
+        entry->kind = Kind::device;
+        entry->dev = &dev;
+        entry->on_device = std::move(handler);
+        entry->on_error = std::move(on_error);
+        insert(dev.get_fd(), EPOLLIN, std::move(entry));
+    }
+
+
+    void
+    EventLoop::add(Uinput& udev,
+                   UinputHandler handler)
+    {
+        int fd = udev.get_fd();
+        int flags = ::fcntl(fd, F_GETFL);
+        if (flags < 0)
+            throw_sys_error(errno, "fcntl()");
+        if (!(flags & O_NONBLOCK))
+            if (::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+                throw_sys_error(errno, "fcntl()");
+
+        auto entry = std::make_shared<Entry>();
+        entry->kind = Kind::uinput;
+        entry->udev = &udev;
+        entry->on_uinput = std::move(handler);
+        insert(fd, EPOLLIN, std::move(entry));
+    }
+
+
+    void
+    EventLoop::add(int fd,
+                   std::uint32_t events,
+                   FdHandler handler)
+    {
+        auto entry = std::make_shared<Entry>();
+        entry->kind = Kind::fd;
+        entry->on_fd = std::move(handler);
+        insert(fd, events, std::move(entry));
+    }
+
+
+    void
+    EventLoop::remove(const Device& dev)
+    {
+        remove(dev.get_fd());
+    }
+
+
+    void
+    EventLoop::remove(const Uinput& udev)
+    {
+        remove(udev.get_fd());
+    }
+
+
+    void
+    EventLoop::remove(int fd)
+    {
+        auto it = entries.find(fd);
+        if (it == entries.end())
+            throw logic_error{"File descriptor is not in the EventLoop."};
+        if (uring) {
+            auto entry = std::move(it->second);
+            entries.erase(it);
+            entry->removed = true;
+            if (entry->pending) {
+                uring_cancel(*entry);
+                try {
+                    uring_reap(*entry);
+                }
+                catch (...) {
+                    if (entry->pending)
+                        retired.push_back(std::move(entry));
+                    throw;
+                }
+            }
+            return;
+        }
+        // Note: if the fd was already closed, it's no longer in the epoll set.
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        it->second->removed = true;
+        entries.erase(it);
+    }
+
+
+    void
+    EventLoop::add_signal(int signo,
+                          SignalHandler handler)
+    {
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigaddset(&mask, signo);
+
+        int e = ::pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+        if (e)
+            throw_sys_error(e, "pthread_sigmask()");
+
+        int fd = ::signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (fd < 0)
+            throw_sys_error(errno, "signalfd()");
+
+        auto entry = std::make_shared<Entry>();
+        entry->kind = Kind::signal;
+        entry->on_signal = std::move(handler);
+        entry->signo = signo;
+        try {
+            insert(fd, EPOLLIN, std::move(entry));
+        }
+        catch (...) {
+            ::close(fd);
+            throw;
+        }
+    }
+
+
+    void
+    EventLoop::remove_signal(int signo)
+    {
+        for (auto& [fd, entry] : entries) {
+            if (entry->kind == Kind::signal && entry->signo == signo) {
+                int sfd = fd;
+                remove(sfd);
+                ::close(sfd);
+
+                sigset_t mask;
+                sigemptyset(&mask);
+                sigaddset(&mask, signo);
+                ::pthread_sigmask(SIG_UNBLOCK, &mask, nullptr);
+                return;
+            }
+        }
+        throw logic_error{"Signal is not in the EventLoop."};
+    }
+
+
+    EventLoop::TimerId
+    EventLoop::add_timer(std::chrono::nanoseconds delay,
+                         std::chrono::nanoseconds interval,
+                         TimerHandler handler)
+    {
+        using std::chrono::duration_cast;
+        using std::chrono::seconds;
+
+        int fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (fd < 0)
+            throw_sys_error(errno, "timerfd_create()");
+
+        auto to_timespec = [](std::chrono::nanoseconds t) -> ::timespec
+        {
+            auto s = duration_cast<seconds>(t);
+            return {
+                .tv_sec = static_cast<std::time_t>(s.count()),
+                .tv_nsec = static_cast<long>((t - s).count())
+            };
+        };
+
+        ::itimerspec spec{
+            .it_interval = to_timespec(interval),
+            .it_value = to_timespec(delay)
+        };
+        // A zero it_value would disarm the timer.
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+            spec.it_value.tv_nsec = 1;
+
+        try {
+            if (::timerfd_settime(fd, 0, &spec, nullptr) < 0)
+                throw_sys_error(errno, "timerfd_settime()");
+
+            auto entry = std::make_shared<Entry>();
+            entry->kind = Kind::timer;
+            entry->on_timer = std::move(handler);
+            insert(fd, EPOLLIN, std::move(entry));
+        }
+        catch (...) {
+            ::close(fd);
+            throw;
+        }
+        return fd;
+    }
+
+
+    void
+    EventLoop::remove_timer(TimerId id)
+    {
+        auto it = entries.find(id);
+        if (it == entries.end() || it->second->kind != Kind::timer)
+            throw logic_error{"Timer is not in the EventLoop."};
+        remove(id);
+        ::close(id);
+    }
+
+
+    std::size_t
+    EventLoop::run_once(std::optional<std::chrono::milliseconds> timeout)
+    {
+        if (uring)
+            return uring_run_once(timeout);
+
+        int ms = timeout ? static_cast<int>(timeout->count()) : -1;
+        int n = ::epoll_wait(epoll_fd, ready.data(), ready.size(), ms);
+        if (n < 0) {
+            if (errno == EINTR)
+                return 0;
+            throw_sys_error(errno, "epoll_wait()");
+        }
+
+        for (int i = 0; i < n; ++i)
+            dispatch(ready[i].data.fd, ready[i].events);
+
+        return n;
+    }
+
+
+    void
+    EventLoop::run()
+    {
+        while (!stop_requested.exchange(false))
+            run_once();
+    }
+
+
+    void
+    EventLoop::stop()
+        noexcept
+    {
+        stop_requested = true;
+        wake_up();
+    }
+
+
+    void
+    EventLoop::post(std::function<void()> command)
+    {
+        {
+            std::lock_guard guard{post_mutex};
+            posted.push_back(std::move(command));
+        }
+        wake_up();
+    }
+
+
+    void
+    EventLoop::wake_up()
+        noexcept
+    {
+        std::uint64_t one = 1;
+        [[maybe_unused]]
+        auto r = ::write(wakeup_fd, &one, sizeof one);
+    }
+
+
+    void
+    EventLoop::run_posted()
+    {
+        std::vector<std::function<void()>> commands;
+        {
+            std::lock_guard guard{post_mutex};
+            commands.swap(posted);
+        }
+        for (auto& command : commands)
+            command();
+    }
+
+
+    void
+    EventLoop::dispatch(int fd,
+                        std::uint32_t events)
+    {
+        if (fd == wakeup_fd) {
+            std::uint64_t count;
+            [[maybe_unused]]
+            auto r = ::read(wakeup_fd, &count, sizeof count);
+            run_posted();
+            return;
+        }
+
+        auto it = entries.find(fd);
+        if (it == entries.end())
+            return; // removed by an earlier handler
+        // keep the entry alive, in case the handler removes it
+        std::shared_ptr<Entry> entry = it->second;
+
+        switch (entry->kind) {
+
+            case Kind::device:
+                drain(fd, *entry);
+                break;
+
+            case Kind::uinput:
+                drain_uinput(fd, *entry);
+                break;
+
+            case Kind::fd:
+                entry->on_fd(fd, events);
+                break;
+
+            case Kind::signal:
+                {
+                    ::signalfd_siginfo info;
+                    while (!entry->removed
+                           && ::read(fd, &info, sizeof info) == sizeof info)
+                        entry->on_signal(static_cast<int>(info.ssi_signo));
+                }
+                break;
+
+            case Kind::timer:
+                {
+                    std::uint64_t expirations;
+                    if (::read(fd, &expirations, sizeof expirations) == sizeof expirations)
+                        while (expirations-- && !entry->removed)
+                            entry->on_timer();
+                }
+                break;
+        }
+    }
+
+
+    void
+    EventLoop::drain(int fd,
+                     Entry& entry,
+                     ReadFlag flags)
+    {
+        for (;;) {
+            ReadStatus status;
+            std::size_t count = entry.dev->read_batch(buffer, status, flags);
+
+            if (count)
+                entry.on_device(*entry.dev, {buffer.data(), count});
+
+            // stop if the handler removed this device
+            auto it = entries.find(fd);
+            if (it == entries.end() || it->second.get() != &entry)
+                return;
+
+            if (status == ReadStatus::dropped) {
+                flags = ReadFlag::resync;
+                continue;
+            }
+
+            if (status == ReadStatus::again) {
+                if (flags == ReadFlag::resync) {
+                    // resync is done, continue reading normally
+                    flags = ReadFlag::normal;
+                    continue;
+                }
+                return;
+            }
+
+            if (status < 0) {
+                fail(fd, entry, -status);
+                return;
+            }
+
+            // buffer was filled, keep reading
+        }
+    }
+
+
+    void
+    EventLoop::drain_uinput(int fd,
+                            Entry& entry)
+    {
+        std::array<::input_event, 16> raw_events;
+        for (;;) {
+            auto r = ::read(fd, raw_events.data(), sizeof raw_events);
+            if (r <= 0)
+                return;
+            std::size_t count = r / sizeof(::input_event);
+            for (std::size_t i = 0; i < count && i < buffer.size(); ++i)
+                buffer[i] = raw_events[i];
+            entry.on_uinput(*entry.udev, {buffer.data(), std::min(count, buffer.size())});
+
+            auto it = entries.find(fd);
+            if (it == entries.end() || it->second.get() != &entry)
+                return;
+        }
+    }
+
+
+
+    void
+    EventLoop::fail(int fd,
+                    Entry& entry,
+                    int error)
+    {
+        std::error_code ec{error, std::system_category()};
+        if (!entry.on_error)
+            throw std::system_error{ec, "Failed to read from device"};
+        Device& dev = *entry.dev;
+        ErrorHandler on_error = std::move(entry.on_error);
+        remove(fd);
+        on_error(dev, ec);
+    }
+
+
+#ifdef HAVE_LIBURING
+
+    // The io_uring requests use a pointer to the entry as user data, with the type of
+    // request in the lower bits. Zero is used for cancellation requests.
+    enum UringOp : std::uint64_t {
+        op_poll      = 1, // wait for a non-device fd to be ready
+        op_link_poll = 2, // wait for a device to be ready, linked to op_read
+        op_read      = 3, // read events from a device
+        op_mask      = 3
+    };
+
+
+    static
+    ::io_uring_sqe*
+    get_sqe(::io_uring* ring,
+            unsigned needed = 1)
+    {
+        if (::io_uring_sq_space_left(ring) < needed)
+            ::io_uring_submit(ring);
+        ::io_uring_sqe* sqe = ::io_uring_get_sqe(ring);
+        if (!sqe)
+            throw runtime_error{"io_uring submission queue is full."};
+        return sqe;
+    }
+
+
+    void
+    EventLoop::uring_init()
+    {
+        auto u = std::make_unique<detail::Uring>();
+        int e = ::io_uring_queue_init(256, &u->ring, 0);
+        if (e < 0)
+            throw_sys_error(-e, "io_uring_queue_init()");
+        uring = std::move(u);
+
+        wakeup_entry = std::make_shared<Entry>();
+        wakeup_entry->kind = Kind::fd;
+        wakeup_entry->fd = wakeup_fd;
+        wakeup_entry->events = POLLIN;
+        try {
+            uring_arm(*wakeup_entry);
+        }
+        catch (...) {
+            ::io_uring_queue_exit(&uring->ring);
+            uring.reset();
+            throw;
+        }
+    }
+
+
+    void
+    EventLoop::uring_destroy()
+        noexcept
+    {
+        try {
+            for (auto& [fd, entry] : entries) {
+                entry->removed = true;
+                if (entry->pending)
+                    uring_cancel(*entry);
+            }
+            wakeup_entry->removed = true;
+            uring_cancel(*wakeup_entry);
+
+            // Wait for the cancellations, so no buffer is written after it's freed.
+            for (int tries = 0; tries < 100; ++tries) {
+                bool busy = wakeup_entry->pending;
+                for (auto& [fd, entry] : entries)
+                    busy = busy || entry->pending;
+                for (auto& entry : retired)
+                    busy = busy || entry->pending;
+                if (!busy)
+                    break;
+                uring_run_once(std::chrono::milliseconds{10});
+            }
+        }
+        catch (...) {}
+        ::io_uring_queue_exit(&uring->ring);
+        uring.reset();
+    }
+
+
+    void
+    EventLoop::uring_arm(Entry& entry)
+    {
+        auto data = reinterpret_cast<std::uint64_t>(&entry);
+        ::io_uring* ring = &uring->ring;
+
+        if (entry.kind == Kind::device) {
+            // The fd is non-blocking, so the read must wait for a poll first.
+            ::io_uring_sqe* sqe = get_sqe(ring, 2);
+            ::io_uring_prep_poll_add(sqe, entry.fd, POLLIN);
+            ::io_uring_sqe_set_flags(sqe, IOSQE_IO_LINK);
+            ::io_uring_sqe_set_data64(sqe, data | op_link_poll);
+
+            sqe = get_sqe(ring);
+            ::io_uring_prep_read(sqe,
+                                 entry.fd,
+                                 entry.raw_buffer.data(),
+                                 entry.raw_buffer.size() * sizeof(::input_event),
+                                 0);
+            ::io_uring_sqe_set_data64(sqe, data | op_read);
+            entry.pending += 2;
+        } else {
+            ::io_uring_sqe* sqe = get_sqe(ring);
+            ::io_uring_prep_poll_add(sqe, entry.fd, entry.events);
+            ::io_uring_sqe_set_data64(sqe, data | op_poll);
+            ++entry.pending;
+        }
+    }
+
+
+    void
+    EventLoop::uring_cancel(Entry& entry)
+    {
+        auto data = reinterpret_cast<std::uint64_t>(&entry);
+        for (std::uint64_t op : {op_poll, op_link_poll, op_read}) {
+            ::io_uring_sqe* sqe = get_sqe(&uring->ring);
+            ::io_uring_prep_cancel64(sqe, data | op, 0);
+            ::io_uring_sqe_set_data64(sqe, 0);
+        }
+    }
+
+
+    std::size_t
+    EventLoop::uring_run_once(std::optional<std::chrono::milliseconds> timeout)
+    {
+        ::io_uring* ring = &uring->ring;
+
+        if (!deferred.empty()) {
+            auto batch = std::exchange(deferred, {});
+            for (auto [data, result] : batch)
+                uring_complete(data, result);
+            return batch.size();
+        }
+
+        ::__kernel_timespec ts{};
+        if (timeout) {
+            ts.tv_sec = timeout->count() / 1000;
+            ts.tv_nsec = (timeout->count() % 1000) * 1000000;
+        }
+
+        ::io_uring_cqe* cqe = nullptr;
+        int e = ::io_uring_submit_and_wait_timeout(ring,
+                                                   &cqe,
+                                                   1,
+                                                   timeout ? &ts : nullptr,
+                                                   nullptr);
+        if (e < 0 && e != -ETIME && e != -EINTR)
+            throw_sys_error(-e, "io_uring_submit_and_wait_timeout()");
+
+        // Copy the completions first, since handlers may submit new requests.
+        std::array<::io_uring_cqe*, 64> cqes;
+        unsigned n = ::io_uring_peek_batch_cqe(ring, cqes.data(), cqes.size());
+        std::array<std::pair<std::uint64_t, int>, 64> done;
+        for (unsigned i = 0; i < n; ++i)
+            done[i] = {::io_uring_cqe_get_data64(cqes[i]), cqes[i]->res};
+        ::io_uring_cq_advance(ring, n);
+
+        for (unsigned i = 0; i < n; ++i)
+            uring_complete(done[i].first, done[i].second);
+
+        return n;
+    }
+
+
+    void
+    EventLoop::uring_complete(std::uint64_t data,
+                              int result)
+    {
+        if (!data)
+            return; // a cancellation request
+
+        auto* e = reinterpret_cast<Entry*>(data & ~std::uint64_t{op_mask});
+        auto op = data & op_mask;
+        --e->pending;
+
+        if (e->removed) {
+            if (!e->pending)
+                std::erase_if(retired,
+                              [e](const auto& r) { return r.get() == e; });
+            return;
+        }
+
+        if (op == op_link_poll) {
+            // The linked read does the actual work, unless the poll itself failed.
+            if (result < 0 && result != -ECANCELED && result != -EINTR) {
+                std::shared_ptr<Entry> entry = entries.at(e->fd);
+                fail(entry->fd, *entry, -result);
+            }
+            return;
+        }
+
+        if (e == wakeup_entry.get()) {
+            std::uint64_t count;
+            [[maybe_unused]]
+            auto r = ::read(wakeup_fd, &count, sizeof count);
+            uring_arm(*e);
+            run_posted();
+            return;
+        }
+
+        // keep the entry alive, in case the handler removes it
+        std::shared_ptr<Entry> entry = entries.at(e->fd);
+
+        if (op == op_poll) {
+            if (result >= 0)
+                dispatch(entry->fd, static_cast<std::uint32_t>(result));
+        } else {
+            if (result > 0)
+                uring_deliver(*entry, result / sizeof(::input_event), buffer);
+            else if (result < 0
+                     && result != -EAGAIN
+                     && result != -EINTR
+                     && result != -ECANCELED) {
+                fail(entry->fd, *entry, -result);
+                return;
+            }
+        }
+
+        if (!entry->removed && !entry->pending)
+            uring_arm(*entry);
+    }
+
+
+    // Wait until all requests of a removed entry complete; a read that completes,
+    // instead of being cancelled, still has its events delivered.
+    void
+    EventLoop::uring_reap(Entry& entry)
+    {
+        const auto data = reinterpret_cast<std::uint64_t>(&entry);
+        ::io_uring* ring = &uring->ring;
+        std::size_t count = 0;
+
+        auto reap = [&](std::uint64_t d, int result) -> bool
+        {
+            if ((d & ~std::uint64_t{op_mask}) != data)
+                return false;
+            --entry.pending;
+            if ((d & op_mask) == op_read && result > 0)
+                count = result / sizeof(::input_event);
+            return true;
+        };
+
+        std::erase_if(deferred,
+                      [&reap](const auto& c) { return reap(c.first, c.second); });
+
+        while (entry.pending) {
+            ::io_uring_cqe* cqe = nullptr;
+            int e = ::io_uring_submit_and_wait_timeout(ring, &cqe, 1, nullptr, nullptr);
+            if (e < 0 && e != -ETIME && e != -EINTR)
+                throw_sys_error(-e, "io_uring_submit_and_wait_timeout()");
+
+            std::array<::io_uring_cqe*, 64> cqes;
+            unsigned n = ::io_uring_peek_batch_cqe(ring, cqes.data(), cqes.size());
+            for (unsigned i = 0; i < n; ++i) {
+                std::uint64_t d = ::io_uring_cqe_get_data64(cqes[i]);
+                if (d && !reap(d, cqes[i]->res))
+                    deferred.emplace_back(d, cqes[i]->res);
+            }
+            ::io_uring_cq_advance(ring, n);
+        }
+
+        if (count) {
+            // The shared buffer may be in use by the handler that called remove().
+            std::vector<Event> out(count);
+            uring_deliver(entry, count, out);
+        }
+    }
+
+
+    void
+    EventLoop::uring_deliver(Entry& entry,
+                             std::size_t count,
+                             std::span<Event> out)
+    {
+        std::span<const ::input_event> events{entry.raw_buffer.data(), count};
+
+        // Events after a SYN_DROPPED are discarded, the resync will replace them.
+        bool dropped = false;
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            if (events[i].type == EV_SYN && events[i].code == SYN_DROPPED) {
+                events = events.first(i + 1);
+                dropped = true;
+                break;
+            }
+        }
+
+        detail::track_state(entry.dev->data(), events);
+
+        for (std::size_t i = 0; i < events.size(); ++i)
+            out[i] = events[i];
+        entry.on_device(*entry.dev, {out.data(), events.size()});
+
+        if (dropped) {
+            // libevdev did not see the SYN_DROPPED, so it must be told to resync; a
+            // removed device is left for its next reader to resync
+            Event ignored;
+            (void) entry.dev->read(ignored, ReadFlag::force_sync);
+            if (!entry.removed)
+                drain(entry.fd, entry, ReadFlag::resync);
+        }
+    }
+
+#else
+
+    // Without liburing, these are never called.
+
+    void
+    EventLoop::uring_init()
+    {
+        throw runtime_error{"io_uring support is not available."};
+    }
+
+
+    void
+    EventLoop::uring_destroy()
+        noexcept
+    {}
+
+
+    void
+    EventLoop::uring_arm(Entry&)
+    {}
+
+
+    void
+    EventLoop::uring_cancel(Entry&)
+    {}
+
+
+    std::size_t
+    EventLoop::uring_run_once(std::optional<std::chrono::milliseconds>)
+    {
+        return 0;
+    }
+
+
+    void
+    EventLoop::uring_complete(std::uint64_t,
+                              int)
+    {}
+
+
+    void
+    EventLoop::uring_reap(Entry&)
+    {}
+
+
+    void
+    EventLoop::uring_deliver(Entry&,
+                             std::size_t,
+                             std::span<Event>)
+    {}
+
+#endif
+
+} // namespace evdev
@@ -0,0 +1,274 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <array>
+#include <cerrno>
+#include <utility>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h> // close()
+#endif
+
+#include <sys/ioctl.h>
+
+#include "libevdevxx/LiteDevice.hpp"
+
+#include "error.hpp"
+#include "read_events.hpp"
+
+
+namespace evdev {
+
+    namespace {
+
+        // Read a string ioctl (EVIOCGNAME, EVIOCGPHYS, EVIOCGUNIQ); no value if missing.
+        template<typename Request>
+        std::optional<std::string>
+        get_string(int fd,
+                   Request request)
+        {
+            std::array<char, 256> buf{};
+            if (::ioctl(fd, request(buf.size() - 1), buf.data()) < 0)
+                return {};
+            return std::string{buf.data()};
+        }
+
+    } // namespace
+
+
+    LiteDevice::LiteDevice()
+        noexcept = default;
+
+
+    LiteDevice::LiteDevice(const std::filesystem::path& filename,
+                           int flags) :
+        fd{::open(filename.c_str(), flags | O_CLOEXEC)},
+        owned{true}
+    {
+        if (fd < 0)
+            throw_sys_error(errno, "open(\"" + filename.string() + "\")");
+    }
+
+
+    LiteDevice::LiteDevice(int f)
+        noexcept :
+        fd{f}
+    {}
+
+
+    LiteDevice::~LiteDevice()
+        noexcept
+    {
+        close();
+    }
+
+
+    LiteDevice::LiteDevice(LiteDevice&& other)
+        noexcept :
+        fd{std::exchange(other.fd, -1)},
+        owned{std::exchange(other.owned, false)},
+        identity{std::move(other.identity)},
+        caps{std::move(other.caps)}
+    {}
+
+
+    LiteDevice&
+    LiteDevice::operator =(LiteDevice&& other)
+        noexcept
+    {
+        if (this != &other) {
+            close();
+            fd = std::exchange(other.fd, -1);
+            owned = std::exchange(other.owned, false);
+            identity = std::move(other.identity);
+            caps = std::move(other.caps);
+        }
+        return *this;
+    }
+
+
+    LiteDevice::operator bool()
+        const noexcept
+    {
+        return fd >= 0;
+    }
+
+
+    void
+    LiteDevice::close()
+        noexcept
+    {
+        if (owned && fd >= 0)
+            ::close(fd);
+        fd = -1;
+        owned = false;
+        identity.reset();
+        caps.reset();
+    }
+
+
+    int
+    LiteDevice::get_fd()
+        const noexcept
+    {
+        return fd;
+    }
+
+
+    const LiteDevice::Identity&
+    LiteDevice::get_identity()
+        const
+    {
+        if (identity)
+            return *identity;
+
+        auto result = std::make_unique<Identity>();
+        if (::ioctl(fd, EVIOCGID, &result->id) < 0)
+            throw_sys_error(errno, "ioctl(EVIOCGID)");
+        if (::ioctl(fd, EVIOCGVERSION, &result->driver_version) < 0)
+            throw_sys_error(errno, "ioctl(EVIOCGVERSION)");
+        result->name = get_string(fd, [](auto len) { return EVIOCGNAME(len); })
+            .value_or("");
+        result->phys = get_string(fd, [](auto len) { return EVIOCGPHYS(len); });
+        result->uniq = get_string(fd, [](auto len) { return EVIOCGUNIQ(len); });
+
+        identity = std::move(result);
+        return *identity;
+    }
+
+
+    const std::string&
+    LiteDevice::get_name()
+        const
+    {
+        return get_identity().name;
+    }
+
+
+    const std::optional<std::string>&
+    LiteDevice::get_phys()
+        const
+    {
+        return get_identity().phys;
+    }
+
+
+    const std::optional<std::string>&
+    LiteDevice::get_uniq()
+        const
+    {
+        return get_identity().uniq;
+    }
+
+
+    std::uint16_t
+    LiteDevice::get_bustype()
+        const
+    {
+        return get_identity().id.bustype;
+    }
+
+
+    std::uint16_t
+    LiteDevice::get_vendor()
+        const
+    {
+        return get_identity().id.vendor;
+    }
+
+
+    std::uint16_t
+    LiteDevice::get_product()
+        const
+    {
+        return get_identity().id.product;
+    }
+
+
+    std::uint16_t
+    LiteDevice::get_version()
+        const
+    {
+        return get_identity().id.version;
+    }
+
+
+    int
+    LiteDevice::get_driver_version()
+        const
+    {
+        return get_identity().driver_version;
+    }
+
+
+    const Capabilities&
+    LiteDevice::get_capabilities()
+        const
+    {
+        if (!caps)
+            caps = std::make_unique<Capabilities>(fd);
+        return *caps;
+    }
+
+
+    AbsInfo
+    LiteDevice::get_abs_info(Code code)
+        const
+    {
+        ::input_absinfo info;
+        if (::ioctl(fd, EVIOCGABS(static_cast<unsigned>(code)), &info) < 0)
+            throw_sys_error(errno, "ioctl(EVIOCGABS)");
+        return info;
+    }
+
+
+    void
+    LiteDevice::grab()
+    {
+        if (::ioctl(fd, EVIOCGRAB, 1) < 0)
+            throw_sys_error(errno, "ioctl(EVIOCGRAB)");
+    }
+
+
+    void
+    LiteDevice::ungrab()
+    {
+        if (::ioctl(fd, EVIOCGRAB, 0) < 0)
+            throw_sys_error(errno, "ioctl(EVIOCGRAB)");
+    }
+
+
+    void
+    LiteDevice::set_clock_id(int clockid)
+    {
+        if (::ioctl(fd, EVIOCSCLOCKID, &clockid) < 0)
+            throw_sys_error(errno, "ioctl(EVIOCSCLOCKID)");
+    }
+
+
+    std::size_t
+    LiteDevice::read(std::span<::input_event> events,
+                     ReadStatus& status)
+        noexcept
+    {
+        return detail::read_events(fd, events, status);
+    }
+
+
+    std::size_t
+    LiteDevice::read(std::span<RawEvent> events,
+                     ReadStatus& status)
+        noexcept
+    {
+        return read(as_input_events(events), status);
+    }
+
+} // namespace evdev
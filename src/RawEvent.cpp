@@ -0,0 +1,29 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <ostream>
+
+#include "libevdevxx/RawEvent.hpp"
+
+
+namespace evdev {
+
+    std::string
+    to_string(const RawEvent& e)
+    {
+        return to_string(Event{e.raw});
+    }
+
+
+    std::ostream&
+    operator <<(std::ostream& out,
+                const RawEvent& e)
+    {
+        return out << to_string(e);
+    }
+
+} // namespace evdev
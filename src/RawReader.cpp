@@ -0,0 +1,67 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "libevdevxx/RawReader.hpp"
+
+#include "read_events.hpp"
+#include "track_state.hpp"
+
+
+namespace evdev {
+
+    RawReader::RawReader()
+        noexcept = default;
+
+
+    RawReader::RawReader(Device& d,
+                         Mode m)
+        noexcept :
+        dev{&d},
+        mode{m}
+    {}
+
+
+    RawReader::Mode
+    RawReader::get_mode()
+        const noexcept
+    {
+        return mode;
+    }
+
+
+    void
+    RawReader::set_mode(Mode m)
+        noexcept
+    {
+        mode = m;
+    }
+
+
+    std::size_t
+    RawReader::read(std::span<::input_event> events,
+                    ReadStatus& status)
+        noexcept
+    {
+        libevdev* raw = dev->data();
+        std::size_t count = detail::read_events(libevdev_get_fd(raw), events, status);
+
+        if (mode == Mode::track_state)
+            detail::track_state(raw, events.first(count));
+
+        return count;
+    }
+
+
+    std::size_t
+    RawReader::read(std::span<RawEvent> events,
+                    ReadStatus& status)
+        noexcept
+    {
+        return read(as_input_events(events), status);
+    }
+
+} // namespace evdev
@@ -0,0 +1,402 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <stdexcept>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "libevdevxx/Reactor.hpp"
+
+
+using std::logic_error;
+
+
+namespace evdev {
+
+    // The CPUs this process is allowed to run on.
+    static
+    std::vector<int>
+    allowed_cpus()
+    {
+        std::vector<int> result;
+        ::cpu_set_t set;
+        CPU_ZERO(&set);
+        if (::sched_getaffinity(0, sizeof set, &set) == 0)
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                if (CPU_ISSET(cpu, &set))
+                    result.push_back(cpu);
+        return result;
+    }
+
+
+    Reactor::Reactor(std::size_t num_shards,
+                     bool pin)
+    {
+        const std::vector<int> cpus = allowed_cpus();
+        if (num_shards == 0)
+            num_shards = std::max<std::size_t>(1, cpus.size());
+
+        try {
+            for (std::size_t i = 0; i < num_shards; ++i) {
+                auto shard = std::make_unique<Shard>();
+                Shard* s = shard.get();
+                shards.push_back(std::move(shard));
+
+                s->thread = std::thread{
+                    [s]
+                    {
+                        while (!s->stopping)
+                            try {
+                                s->loop.run_once();
+                            }
+                            catch (...) {
+                                ++s->errors;
+                            }
+                    }
+                };
+                s->thread_id = s->thread.get_id();
+
+                if (pin && !cpus.empty()) {
+                    int cpu = cpus[i % cpus.size()];
+                    ::cpu_set_t set;
+                    CPU_ZERO(&set);
+                    CPU_SET(cpu, &set);
+                    if (::pthread_setaffinity_np(s->thread.native_handle(),
+                                                 sizeof set,
+                                                 &set) == 0)
+                        s->cpu = cpu;
+                }
+            }
+        }
+        catch (...) {
+            stop_all();
+            throw;
+        }
+
+        last_sample = std::chrono::steady_clock::now();
+    }
+
+
+    Reactor::~Reactor()
+        noexcept
+    {
+        stop_all();
+    }
+
+
+    void
+    Reactor::stop_all()
+        noexcept
+    {
+        for (auto& s : shards) {
+            s->stopping = true;
+            s->loop.stop();
+        }
+        for (auto& s : shards)
+            if (s->thread.joinable())
+                s->thread.join();
+    }
+
+
+    std::size_t
+    Reactor::size()
+        const noexcept
+    {
+        return shards.size();
+    }
+
+
+    void
+    Reactor::attach(Shard& shard,
+                    std::shared_ptr<DeviceState> state)
+    {
+        shard.loop.post(
+            [this, &shard, state]
+            {
+                auto on_events = [&shard, state](Device& dev,
+                                                 std::span<const Event> events)
+                {
+                    state->events.fetch_add(events.size(), std::memory_order_relaxed);
+                    shard.events.fetch_add(events.size(), std::memory_order_relaxed);
+                    shard.batches.fetch_add(1, std::memory_order_relaxed);
+                    state->handler(dev, events);
+                };
+
+                auto on_error = [this, &shard, state](Device& dev,
+                                                      std::error_code error)
+                {
+                    --shard.devices;
+                    {
+                        std::lock_guard guard{mutex};
+                        auto it = devices.find(&dev);
+                        if (it != devices.end() && it->second == state)
+                            devices.erase(it);
+                    }
+                    if (state->on_error)
+                        state->on_error(dev, error);
+                };
+
+                shard.loop.add(*state->dev, std::move(on_events), std::move(on_error));
+                ++shard.devices;
+            });
+    }
+
+
+    void
+    Reactor::call(Shard& shard,
+                  std::function<void()> command)
+    {
+        if (std::this_thread::get_id() == shard.thread_id) {
+            command();
+            return;
+        }
+
+        std::promise<void> done;
+        auto result = done.get_future();
+        shard.loop.post(
+            [&command, &done]
+            {
+                try {
+                    command();
+                    done.set_value();
+                }
+                catch (...) {
+                    done.set_exception(std::current_exception());
+                }
+            });
+        result.get();
+    }
+
+
+    std::size_t
+    Reactor::add(Device& dev,
+                 DeviceHandler handler,
+                 ErrorHandler on_error)
+    {
+        auto state = std::make_shared<DeviceState>();
+        state->dev = &dev;
+        state->handler = std::move(handler);
+        state->on_error = std::move(on_error);
+
+        std::size_t target = 0;
+        {
+            std::lock_guard guard{mutex};
+            if (devices.contains(&dev))
+                throw logic_error{"Device is already in the Reactor."};
+
+            for (std::size_t i = 1; i < shards.size(); ++i) {
+                const Shard& a = *shards[i];
+                const Shard& b = *shards[target];
+                if (a.event_rate < b.event_rate
+                    || (a.event_rate == b.event_rate && a.devices < b.devices))
+                    target = i;
+            }
+            state->shard = target;
+            devices.emplace(&dev, state);
+        }
+
+        attach(*shards[target], std::move(state));
+        return target;
+    }
+
+
+    void
+    Reactor::remove(const Device& dev)
+    {
+        std::lock_guard control{control_mutex};
+
+        std::shared_ptr<DeviceState> state;
+        {
+            std::lock_guard guard{mutex};
+            auto it = devices.find(&dev);
+            if (it == devices.end())
+                throw logic_error{"Device is not in the Reactor."};
+            state = std::move(it->second);
+            devices.erase(it);
+        }
+
+        Shard& shard = *shards[state->shard];
+        call(shard,
+             [&shard, &state]
+             {
+                 try {
+                     shard.loop.remove(*state->dev);
+                     --shard.devices;
+                 }
+                 catch (logic_error&) {
+                     // already removed, after an error
+                 }
+             });
+    }
+
+
+    void
+    Reactor::move(const std::shared_ptr<DeviceState>& state,
+                  std::size_t target)
+    {
+        const std::size_t source = state->shard;
+        if (source == target)
+            return;
+
+        Shard& from = *shards[source];
+        Shard& to = *shards[target];
+        // Remove it on the old shard's thread, so no batch is in flight; only then queue
+        // it on the new shard.
+        call(from,
+             [this, &from, &to, &state, target]
+             {
+                 try {
+                     from.loop.remove(*state->dev);
+                 }
+                 catch (logic_error&) {
+                     return; // already removed, after an error
+                 }
+                 --from.devices;
+                 state->shard = target;
+                 attach(to, state);
+             });
+    }
+
+
+    void
+    Reactor::migrate(const Device& dev,
+                     std::size_t shard)
+    {
+        if (shard >= shards.size())
+            throw std::out_of_range{"Invalid shard index."};
+
+        std::lock_guard control{control_mutex};
+
+        std::shared_ptr<DeviceState> state;
+        {
+            std::lock_guard guard{mutex};
+            auto it = devices.find(&dev);
+            if (it == devices.end())
+                throw logic_error{"Device is not in the Reactor."};
+            state = it->second;
+        }
+        move(state, shard);
+    }
+
+
+    void
+    Reactor::sample_locked()
+    {
+        auto now = std::chrono::steady_clock::now();
+        double dt = std::chrono::duration<double>(now - last_sample).count();
+        if (dt <= 0)
+            return;
+        last_sample = now;
+
+        for (auto& s : shards) {
+            std::uint64_t events = s->events.load(std::memory_order_relaxed);
+            s->event_rate = (events - s->last_events) / dt;
+            s->last_events = events;
+        }
+
+        for (auto& [dev, state] : devices) {
+            std::uint64_t events = state->events.load(std::memory_order_relaxed);
+            state->event_rate = (events - state->last_events) / dt;
+            state->last_events = events;
+        }
+    }
+
+
+    void
+    Reactor::sample()
+    {
+        std::lock_guard guard{mutex};
+        sample_locked();
+    }
+
+
+    std::size_t
+    Reactor::rebalance(std::size_t max_moves)
+    {
+        std::lock_guard control{control_mutex};
+
+        std::vector<double> load(shards.size());
+        std::vector<std::shared_ptr<DeviceState>> states;
+        {
+            std::lock_guard guard{mutex};
+            sample_locked();
+            for (auto& [dev, state] : devices) {
+                load[state->shard] += state->event_rate;
+                states.push_back(state);
+            }
+        }
+
+        std::size_t moved = 0;
+        while (moved < max_moves && shards.size() > 1) {
+            auto [lo, hi] = std::minmax_element(load.begin(), load.end());
+            const std::size_t from = hi - load.begin();
+            const std::size_t to = lo - load.begin();
+            const double gap = *hi - *lo;
+
+            // Moving a device with rate r changes the gap to |gap - 2r|; pick the device
+            // that makes it smallest, if it makes it smaller at all.
+            std::shared_ptr<DeviceState> best;
+            double best_gap = gap;
+            for (auto& state : states) {
+                if (state->shard != from || state->event_rate <= 0)
+                    continue;
+                double new_gap = std::abs(gap - 2 * state->event_rate);
+                if (new_gap < best_gap) {
+                    best_gap = new_gap;
+                    best = state;
+                }
+            }
+            if (!best)
+                break;
+
+            move(best, to);
+            load[from] -= best->event_rate;
+            load[to] += best->event_rate;
+            ++moved;
+        }
+
+        return moved;
+    }
+
+
+    std::vector<Reactor::ShardStats>
+    Reactor::get_stats()
+        const
+    {
+        std::lock_guard guard{mutex};
+        std::vector<ShardStats> result;
+        result.reserve(shards.size());
+        for (auto& s : shards) {
+            ShardStats st;
+            st.cpu = s->cpu;
+            st.devices = s->devices;
+            st.events = s->events.load(std::memory_order_relaxed);
+            st.batches = s->batches.load(std::memory_order_relaxed);
+            st.errors = s->errors.load(std::memory_order_relaxed);
+            st.event_rate = s->event_rate;
+            result.push_back(st);
+        }
+        return result;
+    }
+
+
+    std::size_t
+    Reactor::get_shard(const Device& dev)
+        const
+    {
+        std::lock_guard guard{mutex};
+        auto it = devices.find(&dev);
+        if (it == devices.end())
+            throw logic_error{"Device is not in the Reactor."};
+        return it->second->shard;
+    }
+
+} // namespace evdev
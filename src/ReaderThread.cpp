@@ -0,0 +1,153 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#include "libevdevxx/ReaderThread.hpp"
+
+
+using namespace std::literals;
+
+
+namespace evdev {
+
+    ReaderThread::ReaderThread(Device& d,
+                               EventQueue<Event>& q,
+                               std::size_t bs) :
+        dev{&d},
+        queue{&q},
+        batch_size{bs}
+    {
+        if (batch_size == 0)
+            throw std::logic_error{"ReaderThread batch size must not be zero."};
+        thread = std::thread{[this] { pump(); }};
+    }
+
+
+    ReaderThread::~ReaderThread()
+        noexcept
+    {
+        stop();
+    }
+
+
+    void
+    ReaderThread::stop()
+        noexcept
+    {
+        token.ring();
+        if (thread.joinable())
+            thread.join();
+    }
+
+
+    bool
+    ReaderThread::is_running()
+        const noexcept
+    {
+        return running.load(std::memory_order_acquire);
+    }
+
+
+    std::error_code
+    ReaderThread::get_error()
+        const noexcept
+    {
+        return error;
+    }
+
+
+    std::uint64_t
+    ReaderThread::get_event_count()
+        const noexcept
+    {
+        return event_count.load(std::memory_order_relaxed);
+    }
+
+
+    std::uint64_t
+    ReaderThread::get_stall_count()
+        const noexcept
+    {
+        return stall_count.load(std::memory_order_relaxed);
+    }
+
+
+    void
+    ReaderThread::push_all(std::span<const Event> events)
+        noexcept
+    {
+        event_count.fetch_add(events.size(), std::memory_order_relaxed);
+        for (;;) {
+            events = events.subspan(queue->push(events));
+            if (events.empty() || token.is_rung())
+                return;
+            stall_count.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+        }
+    }
+
+
+    void
+    ReaderThread::pump()
+        noexcept
+    {
+        std::vector<Event> batch;
+        try {
+            batch.resize(batch_size);
+        }
+        catch (std::bad_alloc&) {
+            error = std::make_error_code(std::errc::not_enough_memory);
+            running.store(false, std::memory_order_release);
+            return;
+        }
+
+        ReadFlag flags = ReadFlag::normal;
+        ReadStatus status = ReadStatus::success;
+
+        while (!token.is_rung()) {
+            std::size_t n = dev->read_batch(batch, status, flags);
+            push_all(std::span{batch}.first(n));
+
+            if (status == ReadStatus::dropped) {
+                flags = ReadFlag::resync;
+                continue;
+            }
+
+            if (status == ReadStatus::again) {
+                if (flags & ReadFlag::resync) {
+                    flags = ReadFlag::normal;
+                    continue;
+                }
+                // Nothing left; sleep until the next event.
+                status = dev->read_for(batch[0], 1s, token);
+                if (status == ReadStatus::timeout)
+                    continue;
+                if (status == ReadStatus::canceled)
+                    break;
+                if (status >= 0) {
+                    push_all(std::span{batch}.first(1));
+                    if (status == ReadStatus::dropped)
+                        flags = ReadFlag::resync;
+                    continue;
+                }
+            }
+
+            if (status < 0) {
+                error = std::error_code{-status, std::system_category()};
+                break;
+            }
+        }
+
+        running.store(false, std::memory_order_release);
+        // Let a consumer sleeping on the queue notice it.
+        queue->wake();
+    }
+
+} // namespace evdev
@@ -0,0 +1,115 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "libevdevxx/Resync.hpp"
+
+
+namespace evdev {
+
+    Resync::Resync(Device& d)
+        noexcept :
+        dev{&d},
+        discarded{d.dropped_frame_events},
+        start{std::chrono::steady_clock::now()}
+    {}
+
+
+    void
+    Resync::advance()
+        noexcept
+    {
+        started = true;
+        status = dev->read(delta, ReadFlag::resync);
+        if (status == ReadStatus::dropped) {
+            ++deltas;
+            return;
+        }
+        duration = std::chrono::steady_clock::now() - start;
+        if (status == ReadStatus::again) {
+            // whatever was in flight was drained by libevdev
+            dev->frame_events = 0;
+            dev->dropped_frame_events = 0;
+        }
+    }
+
+
+    Resync::Iterator
+    Resync::begin()
+        noexcept
+    {
+        if (!started)
+            advance();
+        return Iterator{this};
+    }
+
+
+    Resync::Sentinel
+    Resync::end()
+        const noexcept
+    {
+        return {};
+    }
+
+
+    bool
+    Resync::is_done()
+        const noexcept
+    {
+        return started && status != ReadStatus::dropped;
+    }
+
+
+    ReadStatus
+    Resync::get_status()
+        const noexcept
+    {
+        return status;
+    }
+
+
+    std::size_t
+    Resync::get_delta_count()
+        const noexcept
+    {
+        return deltas;
+    }
+
+
+    std::size_t
+    Resync::get_discarded_count()
+        const noexcept
+    {
+        return discarded;
+    }
+
+
+    bool
+    Resync::was_mid_frame()
+        const noexcept
+    {
+        return discarded > 0;
+    }
+
+
+    std::chrono::nanoseconds
+    Resync::get_duration()
+        const noexcept
+    {
+        if (is_done())
+            return duration;
+        return std::chrono::steady_clock::now() - start;
+    }
+
+
+    Resync
+    Device::resync()
+        noexcept
+    {
+        return Resync{*this};
+    }
+
+} // namespace evdev
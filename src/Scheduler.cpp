@@ -0,0 +1,382 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <stdexcept>
+#include <utility>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h> // close()
+#endif
+
+#include <sys/epoll.h>
+
+#include "libevdevxx/Scheduler.hpp"
+#include "libevdevxx/SyncError.hpp"
+
+#include "error.hpp"
+
+
+using std::logic_error;
+
+
+namespace evdev {
+
+    namespace {
+
+        thread_local Scheduler* current_scheduler = nullptr;
+
+    } // namespace
+
+
+    std::coroutine_handle<>
+    Task::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> h)
+        noexcept
+    {
+        promise_type& p = h.promise();
+        if (p.continuation)
+            return p.continuation;
+        if (p.owner)
+            p.owner->finish(h);
+        return std::noop_coroutine();
+    }
+
+
+    Scheduler::Scheduler()
+    {
+        epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0)
+            throw_sys_error(errno, "epoll_create1()");
+    }
+
+
+    Scheduler::~Scheduler()
+        noexcept
+    {
+        // Destroying a root coroutine also destroys the tasks it's awaiting.
+        for (auto h : tasks)
+            h.destroy();
+        ::close(epoll_fd);
+    }
+
+
+    Scheduler*
+    Scheduler::current()
+        noexcept
+    {
+        return current_scheduler;
+    }
+
+
+    void
+    Scheduler::spawn(Task task)
+    {
+        if (task.done())
+            throw logic_error{"Cannot spawn an empty or finished Task."};
+
+        // Reserve space, so finish() never allocates.
+        tasks.reserve(tasks.size() + 1);
+        finished.reserve(tasks.size() + 1);
+        ready.reserve(tasks.size() + 1);
+
+        auto h = task.release();
+        h.promise().owner = this;
+        tasks.push_back(h);
+        ready.push_back(h);
+    }
+
+
+    std::size_t
+    Scheduler::size()
+        const noexcept
+    {
+        return tasks.size();
+    }
+
+
+    void
+    Scheduler::finish(Task::handle_type h)
+        noexcept
+    {
+        finished.push_back(h);
+    }
+
+
+    void
+    Scheduler::reap()
+    {
+        std::exception_ptr error;
+        for (auto h : finished) {
+            std::erase(tasks, h);
+            if (!error)
+                error = h.promise().error;
+            h.destroy();
+        }
+        finished.clear();
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+
+    void
+    Scheduler::run()
+    {
+        struct Guard {
+            Scheduler* previous;
+
+            Guard(Scheduler* s) noexcept :
+                previous{std::exchange(current_scheduler, s)}
+            {}
+
+            ~Guard() noexcept
+            {
+                current_scheduler = previous;
+            }
+        } guard{this};
+
+        std::array<::epoll_event, 64> events;
+
+        while (!tasks.empty()) {
+            // Resumed tasks may append to the ready list, so don't use iterators here.
+            for (std::size_t i = 0; i < ready.size(); ++i)
+                ready[i].resume();
+            ready.clear();
+            reap();
+
+            if (tasks.empty())
+                break;
+            if (!waiting)
+                throw logic_error{"All tasks are suspended, but none is waiting on a device."};
+
+            int n = ::epoll_wait(epoll_fd, events.data(), events.size(), -1);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw_sys_error(errno, "epoll_wait()");
+            }
+
+            for (int i = 0; i < n; ++i) {
+                auto* slot = static_cast<Slot*>(events[i].data.ptr);
+                detail::Waiter* w = slot->waiter;
+                if (w && w->try_complete(*w)) {
+                    slot->waiter = nullptr;
+                    --waiting;
+                    ready.push_back(w->handle);
+                }
+            }
+        }
+    }
+
+
+    void
+    Scheduler::wait_readable(int fd,
+                             detail::Waiter& waiter)
+    {
+        auto& slot = slots[fd];
+        if (!slot) {
+            slot = std::make_unique<Slot>();
+            slot->fd = fd;
+            ::epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLET;
+            ev.data.ptr = slot.get();
+            if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+                int e = errno;
+                slots.erase(fd);
+                throw_sys_error(e, "epoll_ctl()");
+            }
+        }
+
+        if (slot->waiter)
+            throw logic_error{"Another coroutine is already waiting on this file descriptor."};
+
+        slot->waiter = &waiter;
+        ++waiting;
+    }
+
+
+    void
+    Scheduler::forget(int fd)
+        noexcept
+    {
+        auto it = slots.find(fd);
+        if (it == slots.end())
+            return;
+        if (it->second->waiter)
+            --waiting;
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        slots.erase(it);
+    }
+
+
+    // ------------ //
+    // EventAwaiter //
+    // ------------ //
+
+
+    EventAwaiter::EventAwaiter(Device& d,
+                               ReadFlag f,
+                               ReadStatus* out)
+        noexcept :
+        dev{&d},
+        flags{f},
+        out_status{out}
+    {
+        try_complete = complete;
+    }
+
+
+    bool
+    EventAwaiter::complete(detail::Waiter& self)
+        noexcept
+    {
+        auto& a = static_cast<EventAwaiter&>(self);
+        a.status = a.dev->read(a.event, a.flags);
+        return a.status != ReadStatus::again;
+    }
+
+
+    bool
+    EventAwaiter::await_ready()
+        noexcept
+    {
+        return complete(*this);
+    }
+
+
+    void
+    EventAwaiter::await_suspend(std::coroutine_handle<> h)
+    {
+        Scheduler* sched = Scheduler::current();
+        if (!sched)
+            throw logic_error{"Device::next_event() must be awaited inside a Scheduler."};
+        handle = h;
+        sched->wait_readable(dev->get_fd(), *this);
+    }
+
+
+    Event
+    EventAwaiter::await_resume()
+    {
+        if (out_status) {
+            *out_status = status;
+            return event;
+        }
+
+        if (status == ReadStatus::dropped && (flags & ReadFlag::resync) == 0)
+            throw SyncError{event};
+
+        int e = static_cast<int>(status);
+        if (e < 0)
+            throw_sys_error(-e, "libevdev_next_event()");
+
+        return event;
+    }
+
+
+    // ------------ //
+    // FrameAwaiter //
+    // ------------ //
+
+
+    FrameAwaiter::FrameAwaiter(Device& d,
+                               EventFrame& fr,
+                               ReadFlag f)
+        noexcept :
+        dev{&d},
+        frame{&fr},
+        flags{f}
+    {
+        try_complete = complete;
+    }
+
+
+    bool
+    FrameAwaiter::complete(detail::Waiter& self)
+        noexcept
+    {
+        auto& a = static_cast<FrameAwaiter&>(self);
+        try {
+            a.status = a.dev->read_frame(*a.frame, a.flags);
+        }
+        catch (...) {
+            a.error = std::current_exception();
+            return true;
+        }
+        return a.status != ReadStatus::again;
+    }
+
+
+    bool
+    FrameAwaiter::await_ready()
+        noexcept
+    {
+        return complete(*this);
+    }
+
+
+    void
+    FrameAwaiter::await_suspend(std::coroutine_handle<> h)
+    {
+        Scheduler* sched = Scheduler::current();
+        if (!sched)
+            throw logic_error{"Device::next_frame() must be awaited inside a Scheduler."};
+        handle = h;
+        sched->wait_readable(dev->get_fd(), *this);
+    }
+
+
+    ReadStatus
+    FrameAwaiter::await_resume()
+    {
+        if (error)
+            std::rethrow_exception(error);
+
+        int e = static_cast<int>(status);
+        if (e < 0)
+            throw_sys_error(-e, "libevdev_next_event()");
+
+        return status;
+    }
+
+
+    // ------------------- //
+    // Device's awaitables //
+    // ------------------- //
+
+
+    EventAwaiter
+    Device::next_event(ReadFlag flags)
+        noexcept
+    {
+        return EventAwaiter{*this, flags};
+    }
+
+
+    EventAwaiter
+    Device::next_event(ReadStatus& status,
+                       ReadFlag flags)
+        noexcept
+    {
+        return EventAwaiter{*this, flags, &status};
+    }
+
+
+    FrameAwaiter
+    Device::next_frame(EventFrame& frame,
+                       ReadFlag flags)
+        noexcept
+    {
+        return FrameAwaiter{*this, frame, flags};
+    }
+
+} // namespace evdev
@@ -5,15 +5,40 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <stdexcept>
 #include <utility>
+#include <vector>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h> // close()
+#endif
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+
+#include <linux/uinput.h>
 
 #include "libevdevxx/Uinput.hpp"
+#include "libevdevxx/DeviceInfo.hpp"
 
 #include "error.hpp"
+#include "utils.hpp"
 
 
 using std::runtime_error;
+using std::chrono::steady_clock;
 
 
 namespace evdev {
@@ -38,12 +63,31 @@ namespace evdev {
 
 
     Uinput::Uinput(Uinput&& other)
-        noexcept = default;
+        noexcept :
+        BaseType{std::move(other)},
+        shadow{other.shadow},
+        native_fd{std::exchange(other.native_fd, -1)},
+        native_owned{std::exchange(other.native_owned, false)},
+        syspath{std::move(other.syspath)},
+        devnode{std::move(other.devnode)}
+    {}
 
 
     Uinput&
     Uinput::operator =(Uinput&& other)
-        noexcept = default;
+        noexcept
+    {
+        if (this != &other) {
+            destroy();
+            acquire(other.release());
+            shadow = other.shadow;
+            native_fd = std::exchange(other.native_fd, -1);
+            native_owned = std::exchange(other.native_owned, false);
+            syspath = std::move(other.syspath);
+            devnode = std::move(other.devnode);
+        }
+        return *this;
+    }
 
 
 
@@ -59,6 +103,308 @@ namespace evdev {
             throw_sys_error(-e, "from libevdev_uinput_create_from_device()");
         destroy();
         acquire(udev);
+        reset_shadow(dev);
+    }
+
+
+    namespace {
+
+        // The ioctl that enables a code of each type, or 0 if there's none.
+        unsigned long
+        set_bit_request(unsigned type)
+            noexcept
+        {
+            switch (type) {
+                case EV_KEY:
+                    return UI_SET_KEYBIT;
+                case EV_REL:
+                    return UI_SET_RELBIT;
+                case EV_MSC:
+                    return UI_SET_MSCBIT;
+                case EV_SW:
+                    return UI_SET_SWBIT;
+                case EV_LED:
+                    return UI_SET_LEDBIT;
+                case EV_SND:
+                    return UI_SET_SNDBIT;
+                case EV_FF:
+                    return UI_SET_FFBIT;
+                default:
+                    return 0;
+            }
+        }
+
+
+        void
+        setup_device(int fd,
+                     const std::string& name,
+                     const std::optional<std::string>& phys,
+                     const ::input_id& id,
+                     const Capabilities& caps,
+                     unsigned ff_effects_max)
+        {
+            for (std::size_t t : caps.get_types()) {
+                if (t == EV_SYN)
+                    continue;
+                // the kernel refuses EV_FF without effect slots
+                if (t == EV_FF && !ff_effects_max)
+                    continue;
+                if (::ioctl(fd, UI_SET_EVBIT, t) < 0)
+                    throw_sys_error(errno, "ioctl(UI_SET_EVBIT)");
+
+                const auto& codes = caps.get_codes(Type{static_cast<std::uint16_t>(t)});
+
+                if (t == EV_ABS) {
+                    // UI_ABS_SETUP enables the axis too
+                    for (std::size_t c : codes) {
+                        ::uinput_abs_setup abs{};
+                        abs.code = c;
+                        abs.absinfo = caps.get_abs_info(Code{static_cast<Code::value_type>(c)});
+                        if (::ioctl(fd, UI_ABS_SETUP, &abs) < 0)
+                            throw_sys_error(errno, "ioctl(UI_ABS_SETUP)");
+                    }
+                    continue;
+                }
+
+                unsigned long request = set_bit_request(t);
+                if (!request)
+                    continue;
+                for (std::size_t c : codes)
+                    if (::ioctl(fd, request, c) < 0)
+                        throw_sys_error(errno, "ioctl(UI_SET_*BIT)");
+            }
+
+            for (std::size_t p : caps.get_properties())
+                if (::ioctl(fd, UI_SET_PROPBIT, p) < 0)
+                    throw_sys_error(errno, "ioctl(UI_SET_PROPBIT)");
+
+            if (phys && ::ioctl(fd, UI_SET_PHYS, phys->c_str()) < 0)
+                throw_sys_error(errno, "ioctl(UI_SET_PHYS)");
+
+            ::uinput_setup setup{};
+            setup.id = id;
+            std::strncpy(setup.name, name.c_str(), sizeof setup.name - 1);
+            setup.ff_effects_max = ff_effects_max;
+            if (::ioctl(fd, UI_DEV_SETUP, &setup) < 0)
+                throw_sys_error(errno, "ioctl(UI_DEV_SETUP)");
+
+            if (::ioctl(fd, UI_DEV_CREATE) < 0)
+                throw_sys_error(errno, "ioctl(UI_DEV_CREATE)");
+        }
+
+
+        // Same as the kernel's input_defuzz_abs_event(): small moves are ignored or
+        // smoothed, and the value stored is the result.
+        std::int32_t
+        defuzz(std::int32_t value,
+               std::int32_t old,
+               std::int32_t fuzz)
+            noexcept
+        {
+            if (fuzz) {
+                const std::int64_t v = value;
+                const std::int64_t o = old;
+                if (v > o - fuzz / 2 && v < o + fuzz / 2)
+                    return old;
+                if (v > o - fuzz && v < o + fuzz)
+                    return static_cast<std::int32_t>((o * 3 + v) / 4);
+                if (v > o - std::int64_t{fuzz} * 2 && v < o + std::int64_t{fuzz} * 2)
+                    return static_cast<std::int32_t>((o + v) / 2);
+            }
+            return value;
+        }
+
+
+        // The event node of a device, from the `eventN` entry in its sysfs directory.
+        std::optional<std::filesystem::path>
+        find_event_node(const std::filesystem::path& sys)
+        {
+            std::error_code ec;
+            for (const auto& entry : std::filesystem::directory_iterator{sys, ec}) {
+                auto filename = entry.path().filename().string();
+                if (detail::parse_event_node(filename))
+                    return std::filesystem::path{"/dev/input"} / filename;
+            }
+            return {};
+        }
+
+    } // namespace
+
+
+    void
+    Uinput::create_native(const Device& dev,
+                          unsigned ff_effects_max,
+                          int fd)
+    {
+        const libevdev* src = dev.data();
+        ::input_id id{};
+        id.bustype = libevdev_get_id_bustype(src);
+        id.vendor = libevdev_get_id_vendor(src);
+        id.product = libevdev_get_id_product(src);
+        id.version = libevdev_get_id_version(src);
+        const char* phys = libevdev_get_phys(src);
+        create_native(dev.get_name(),
+                      phys ? std::optional<std::string>{phys} : std::nullopt,
+                      id,
+                      Capabilities{dev},
+                      ff_effects_max,
+                      fd);
+    }
+
+
+    void
+    Uinput::create_native(const DeviceInfo& info,
+                          unsigned ff_effects_max,
+                          int fd)
+    {
+        ::input_id id{};
+        id.bustype = info.bustype;
+        id.vendor = info.vendor;
+        id.product = info.product;
+        id.version = info.version;
+        create_native(info.name, info.phys, id, info.caps, ff_effects_max, fd);
+    }
+
+
+    void
+    Uinput::create_native(const std::string& name,
+                          const std::optional<std::string>& phys,
+                          const ::input_id& id,
+                          const Capabilities& caps,
+                          unsigned ff_effects_max,
+                          int fd)
+    {
+        bool owned = fd < 0;
+        if (owned) {
+            fd = ::open("/dev/uinput", O_RDWR | O_CLOEXEC);
+            if (fd < 0)
+                throw_sys_error(errno, "open(\"/dev/uinput\")");
+        }
+
+        try {
+            setup_device(fd, name, phys, id, caps, ff_effects_max);
+        }
+        catch (...) {
+            if (owned)
+                ::close(fd);
+            throw;
+        }
+
+        destroy();
+        native_fd = fd;
+        native_owned = owned;
+        reset_shadow(caps);
+
+        // The sysfs entry and the event node are created along with the device, so
+        // they can be resolved now, once. Without them, the device can't be found.
+        std::array<char, 64> sysname{};
+        if (::ioctl(fd, UI_GET_SYSNAME(sysname.size() - 1), sysname.data()) < 0) {
+            int error = errno;
+            destroy();
+            throw_sys_error(error, "ioctl(UI_GET_SYSNAME)");
+        }
+        std::filesystem::path sys = "/sys/devices/virtual/input";
+        sys /= sysname.data();
+        devnode = find_event_node(sys);
+        syspath = std::move(sys);
+    }
+
+
+    void
+    Uinput::reset_shadow(const Capabilities& caps)
+        noexcept
+    {
+        shadow.keys.clear();
+        shadow.switches.clear();
+        shadow.tracked_axes.clear();
+        shadow.axes.fill(0);
+        shadow.fuzz.fill(0);
+        shadow.frame_pending = false;
+
+        for (std::size_t c : caps.get_codes(Type::abs)) {
+            if (detail::is_mt_axis(c))
+                continue;
+            const AbsInfo& abs = caps.get_abs_info(Code{static_cast<Code::value_type>(c)});
+            shadow.tracked_axes.set(c);
+            shadow.axes[c] = abs.val;
+            shadow.fuzz[c] = abs.fuzz;
+        }
+    }
+
+
+    void
+    Uinput::reset_shadow(const Device& dev)
+        noexcept
+    {
+        shadow.keys.clear();
+        shadow.switches.clear();
+        shadow.tracked_axes.clear();
+        shadow.axes.fill(0);
+        shadow.fuzz.fill(0);
+        shadow.frame_pending = false;
+
+        const libevdev* src = dev.data();
+        for (unsigned c = 0; c < ABS_CNT; ++c) {
+            if (detail::is_mt_axis(c) || !libevdev_has_event_code(src, EV_ABS, c))
+                continue;
+            shadow.tracked_axes.set(c);
+            shadow.axes[c] = libevdev_get_event_value(src, EV_ABS, c);
+            shadow.fuzz[c] = libevdev_get_abs_fuzz(src, c);
+        }
+    }
+
+
+    bool
+    Uinput::Shadow::update(std::uint16_t type,
+                           std::uint16_t code,
+                           std::int32_t value)
+        noexcept
+    {
+        // same rules as the kernel's input_get_disposition()
+        bool changed = true;
+        switch (type) {
+            case EV_SYN:
+                if (code == SYN_REPORT) {
+                    changed = frame_pending;
+                    frame_pending = false;
+                    break;
+                }
+                frame_pending = true;
+                break;
+
+            case EV_KEY:
+                // autorepeats are always passed on
+                if (value != 2 && code < KEY_CNT) {
+                    changed = keys.test(code) != (value != 0);
+                    keys.set(code, value != 0);
+                }
+                break;
+
+            case EV_SW:
+                if (code < SW_CNT) {
+                    changed = switches.test(code) != (value != 0);
+                    switches.set(code, value != 0);
+                }
+                break;
+
+            case EV_ABS:
+                if (code < ABS_CNT && !detail::is_mt_axis(code) && tracked_axes.test(code)) {
+                    // the kernel compares and stores the defuzzed value
+                    value = defuzz(value, axes[code], fuzz[code]);
+                    changed = axes[code] != value;
+                    axes[code] = value;
+                }
+                break;
+        }
+
+        if (!changed) {
+            ++elided;
+            return false;
+        }
+        if (type != EV_SYN)
+            frame_pending = true;
+        ++written;
+        return true;
     }
 
 
@@ -69,6 +415,39 @@ namespace evdev {
         auto old_raw = BaseType::release();
         if (old_raw)
             libevdev_uinput_destroy(old_raw);
+
+        if (native_fd >= 0) {
+            ::ioctl(native_fd, UI_DEV_DESTROY);
+            if (native_owned)
+                ::close(native_fd);
+        }
+        native_fd = -1;
+        native_owned = false;
+        syspath.reset();
+        devnode.reset();
+    }
+
+
+    bool
+    Uinput::is_valid()
+        const noexcept
+    {
+        return raw || native_fd >= 0;
+    }
+
+
+    Uinput::operator bool()
+        const noexcept
+    {
+        return is_valid();
+    }
+
+
+    bool
+    Uinput::is_native()
+        const noexcept
+    {
+        return native_fd >= 0;
     }
 
 
@@ -76,6 +455,8 @@ namespace evdev {
     Uinput::get_fd()
         const noexcept
     {
+        if (native_fd >= 0)
+            return native_fd;
         return libevdev_uinput_get_fd(raw);
     }
 
@@ -95,10 +476,10 @@ namespace evdev {
     Uinput::try_get_syspath()
         const
     {
-        const char* p = libevdev_uinput_get_syspath(raw);
-        if (!p)
-            return {};
-        return std::filesystem::path{p};
+        if (!syspath && raw)
+            if (const char* p = libevdev_uinput_get_syspath(raw))
+                syspath = p;
+        return syspath;
     }
 
 
@@ -117,10 +498,145 @@ namespace evdev {
     Uinput::try_get_devnode()
         const
     {
-        const char* p = libevdev_uinput_get_devnode(raw);
-        if (!p)
-            return {};
-        return std::filesystem::path{p};
+        // libevdev scans sysfs on every call
+        if (!devnode && raw)
+            if (const char* p = libevdev_uinput_get_devnode(raw))
+                devnode = p;
+        // the event node may not have been registered yet at creation
+        if (!devnode && native_fd >= 0 && syspath)
+            devnode = find_event_node(*syspath);
+        return devnode;
+    }
+
+
+    namespace {
+
+        // Check if a node can be opened and read; false if it's missing, not accessible
+        // yet, or its device is not registered.
+        bool
+        can_read(const std::filesystem::path& node)
+        {
+            int fd = ::open(node.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+            if (fd < 0) {
+                if (errno == ENOENT || errno == EACCES || errno == EPERM)
+                    return false;
+                throw_sys_error(errno, "open(\"" + node.string() + "\")");
+            }
+            // events read here are only taken from this file's own queue
+            ::input_event event;
+            ssize_t r = ::read(fd, &event, sizeof event);
+            int error = errno;
+            ::close(fd);
+            if (r >= 0 || error == EAGAIN)
+                return true;
+            if (error == ENODEV)
+                return false;
+            throw_sys_error(error, "read(\"" + node.string() + "\")");
+        }
+
+    } // namespace
+
+
+    bool
+    Uinput::wait_ready(std::chrono::milliseconds timeout)
+        const
+    {
+        const Uinput* self = this;
+        return wait_ready(std::span{&self, 1}, timeout);
+    }
+
+
+    bool
+    Uinput::wait_ready(std::span<const Uinput* const> devices,
+                       std::chrono::milliseconds timeout)
+    {
+        const auto deadline = steady_clock::now() + timeout;
+
+        std::vector<std::filesystem::path> pending;
+        std::vector<std::filesystem::path> dirs;
+        std::vector<bool> watched;
+        // Devices whose node is not known yet; it shows up in /dev/input.
+        std::vector<const Uinput*> unresolved;
+
+        // Returns false if the node is not known yet.
+        auto add_node = [&pending, &dirs, &watched](const Uinput* udev)
+        {
+            auto node = udev->try_get_devnode();
+            if (!node)
+                return false;
+            auto dir = node->parent_path();
+            if (std::ranges::find(dirs, dir) == dirs.end()) {
+                dirs.push_back(std::move(dir));
+                watched.push_back(false);
+            }
+            pending.push_back(std::move(*node));
+            return true;
+        };
+
+        for (const Uinput* udev : devices)
+            if (!add_node(udev))
+                unresolved.push_back(udev);
+        if (!unresolved.empty() && std::ranges::find(dirs, "/dev/input") == dirs.end()) {
+            dirs.emplace_back("/dev/input");
+            watched.push_back(false);
+        }
+
+        int inotify_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_fd < 0)
+            throw_sys_error(errno, "inotify_init1()");
+        struct Guard {
+            int fd;
+
+            ~Guard() noexcept
+            {
+                ::close(fd);
+            }
+        } guard{inotify_fd};
+
+        const std::uint32_t mask = IN_CREATE | IN_ATTRIB | IN_MOVED_TO;
+
+        for (;;) {
+            for (std::size_t i = 0; i < dirs.size(); ++i) {
+                if (watched[i])
+                    continue;
+                if (::inotify_add_watch(inotify_fd, dirs[i].c_str(), mask) >= 0) {
+                    watched[i] = true;
+                    continue;
+                }
+                if (errno != ENOENT)
+                    throw_sys_error(errno, "inotify_add_watch()");
+                // the directory itself isn't there yet; wait for it to be created
+                if (::inotify_add_watch(inotify_fd, dirs[i].parent_path().c_str(), mask) < 0)
+                    throw_sys_error(errno, "inotify_add_watch()");
+            }
+
+            // A newly found node may live in a directory that is not watched yet.
+            const std::size_t num_dirs = dirs.size();
+            std::erase_if(unresolved, add_node);
+            if (dirs.size() != num_dirs)
+                continue;
+
+            // The watches are set before checking, so no change can be missed.
+            std::erase_if(pending, can_read);
+            if (pending.empty() && unresolved.empty())
+                return true;
+
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline
+                                                                     - steady_clock::now());
+            if (left.count() <= 0)
+                return false;
+
+            ::pollfd pfd{inotify_fd, POLLIN, 0};
+            int wait_ms = static_cast<int>(std::min<std::chrono::milliseconds::rep>(left.count(),
+                                                                                  1000 * 60));
+            if (::poll(&pfd, 1, wait_ms) < 0 && errno != EINTR)
+                throw_sys_error(errno, "poll()");
+
+            // Which entries changed doesn't matter, all pending nodes are tried again.
+            alignas(::inotify_event) std::array<char, 4096> buf;
+            while (::read(inotify_fd, buf.data(), buf.size()) > 0)
+                ;
+        }
     }
 
 
@@ -129,9 +645,18 @@ namespace evdev {
                   Code code,
                   int value)
     {
-        int e = libevdev_uinput_write_event(raw, type, code, value);
-        if (e < 0)
-            throw_sys_error(-e, "from libevdev_uinput_write_event");
+        Shadow next = shadow;
+        if (next.update(type, code, value)) {
+            // same as libevdev_uinput_write_event(), but works on native devices too
+            ::input_event e{};
+            e.type = type;
+            e.code = code;
+            e.value = value;
+            while (::write(get_fd(), &e, sizeof e) < 0)
+                if (errno != EINTR)
+                    throw_sys_error(errno, "write()");
+        }
+        shadow = next;
     }
 
 
@@ -150,6 +675,103 @@ namespace evdev {
     }
 
 
+    namespace {
+
+        // Write all the buffers, resuming after partial writes.
+        void
+        write_all(int fd,
+                  std::span<::iovec> iov)
+        {
+            while (!iov.empty()) {
+                ssize_t w = ::writev(fd, iov.data(), iov.size());
+                if (w < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    throw_sys_error(errno, "writev()");
+                }
+                auto written = static_cast<std::size_t>(w);
+                while (!iov.empty() && written >= iov.front().iov_len) {
+                    written -= iov.front().iov_len;
+                    iov = iov.subspan(1);
+                }
+                if (written) {
+                    auto& front = iov.front();
+                    front.iov_base = static_cast<char*>(front.iov_base) + written;
+                    front.iov_len -= written;
+                }
+            }
+        }
+
+    } // namespace
+
+
+    std::size_t
+    Uinput::write(std::span<const ::input_event> events,
+                  bool sync)
+    {
+        // The events are filtered against a copy of the shadow state, that only
+        // replaces it once they're written. Only copy the events if some are elided.
+        Shadow next = shadow;
+        std::vector<::input_event> kept;
+        std::size_t i = 0;
+        for (; i < events.size(); ++i)
+            if (!next.update(events[i].type, events[i].code, events[i].value))
+                break;
+        if (i < events.size()) {
+            kept.reserve(events.size());
+            kept.assign(events.begin(), events.begin() + i);
+            for (++i; i < events.size(); ++i)
+                if (next.update(events[i].type, events[i].code, events[i].value))
+                    kept.push_back(events[i]);
+            events = kept;
+        }
+
+        sync = sync && next.update(EV_SYN, SYN_REPORT, 0);
+        if (events.empty() && !sync) {
+            shadow = next;
+            return 0;
+        }
+
+        ::input_event report{};
+        report.type = EV_SYN;
+        report.code = SYN_REPORT;
+
+        std::array<::iovec, 2> iov{{
+            { const_cast<::input_event*>(events.data()), events.size_bytes() },
+            { &report, sizeof report },
+        }};
+        write_all(get_fd(), std::span{iov}.first(sync ? 2 : 1));
+        shadow = next;
+        return events.size();
+    }
+
+
+    std::size_t
+    Uinput::write(std::span<const Event> events,
+                  bool sync)
+    {
+        // small frames are converted on the stack
+        constexpr std::size_t stack_size = 64;
+        std::array<::input_event, stack_size> stack_buf;
+        std::vector<::input_event> heap_buf;
+        std::span<::input_event> buf = stack_buf;
+        if (events.size() > stack_size) {
+            heap_buf.resize(events.size());
+            buf = heap_buf;
+        }
+
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            ::input_event& e = buf[i];
+            e = {};
+            e.type = events[i].type;
+            e.code = events[i].code;
+            e.value = events[i].value;
+        }
+
+        return write(std::span<const ::input_event>{buf.first(events.size())}, sync);
+    }
+
+
     void
     Uinput::write_syn(Code code,
                       int value)
@@ -247,4 +869,55 @@ namespace evdev {
         write_syn(Code{SYN_REPORT}, 0);
     }
 
+
+    int
+    Uinput::get_value(Type type,
+                      Code code)
+        const noexcept
+    {
+        switch (type) {
+            case Type::key:
+                return shadow.keys.test(code);
+            case Type::sw:
+                return shadow.switches.test(code);
+            case Type::abs:
+                return code < ABS_CNT ? shadow.axes[code] : 0;
+            default:
+                return 0;
+        }
+    }
+
+
+    const BitSet<KEY_CNT>&
+    Uinput::get_keys()
+        const noexcept
+    {
+        return shadow.keys;
+    }
+
+
+    std::uint64_t
+    Uinput::get_written_count()
+        const noexcept
+    {
+        return shadow.written;
+    }
+
+
+    std::uint64_t
+    Uinput::get_elided_count()
+        const noexcept
+    {
+        return shadow.elided;
+    }
+
+
+    void
+    Uinput::reset_counters()
+        noexcept
+    {
+        shadow.written = 0;
+        shadow.elided = 0;
+    }
+
 } // namespace evdev
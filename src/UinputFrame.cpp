@@ -0,0 +1,184 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <limits>
+#include <span>
+
+#include "libevdevxx/UinputFrame.hpp"
+
+#include "utils.hpp"
+
+
+namespace evdev {
+
+    UinputFrame::UinputFrame(Uinput& u) :
+        udev{&u},
+        keys_down{u.get_keys()}
+    {
+        abs_index.fill(none);
+        rel_index.fill(none);
+    }
+
+
+    void
+    UinputFrame::append(std::uint16_t type,
+                        std::uint16_t code,
+                        std::int32_t value)
+    {
+        ::input_event& e = events.emplace_back();
+        e.type = type;
+        e.code = code;
+        e.value = value;
+    }
+
+
+    void
+    UinputFrame::write_key(Code code,
+                           int value)
+    {
+        // same rule as the Uinput shadow state: any value but 2 sets the key state
+        if (value != 2 && code < KEY_CNT) {
+            if (keys_down.test(code) == (value != 0))
+                return;
+            keys_down.set(code, value != 0);
+        }
+        append(EV_KEY, code, value);
+    }
+
+
+    void
+    UinputFrame::write_abs(Code code,
+                           int value)
+    {
+        // multitouch axes apply to the current slot, so their order matters
+        if (code >= ABS_CNT || detail::is_mt_axis(code)) {
+            append(EV_ABS, code, value);
+            return;
+        }
+        if (abs_index[code] != none) {
+            events[abs_index[code]].value = value;
+            return;
+        }
+        abs_index[code] = events.size();
+        append(EV_ABS, code, value);
+    }
+
+
+    void
+    UinputFrame::write_rel(Code code,
+                           int value)
+    {
+        if (code >= REL_CNT) {
+            append(EV_REL, code, value);
+            return;
+        }
+        if (rel_index[code] != none) {
+            // saturate, instead of overflowing
+            using limits = std::numeric_limits<std::int32_t>;
+            std::int32_t& sum = events[rel_index[code]].value;
+            sum = std::clamp<std::int64_t>(std::int64_t{sum} + value, limits::min(), limits::max());
+            return;
+        }
+        rel_index[code] = events.size();
+        append(EV_REL, code, value);
+    }
+
+
+    void
+    UinputFrame::write(Type type,
+                       Code code,
+                       int value)
+    {
+        switch (type) {
+            case Type::key:
+                write_key(code, value);
+                break;
+            case Type::abs:
+                write_abs(code, value);
+                break;
+            case Type::rel:
+                write_rel(code, value);
+                break;
+            default:
+                append(type, code, value);
+        }
+    }
+
+
+    std::size_t
+    UinputFrame::size()
+        const noexcept
+    {
+        return events.size();
+    }
+
+
+    bool
+    UinputFrame::empty()
+        const noexcept
+    {
+        return events.empty();
+    }
+
+
+    std::size_t
+    UinputFrame::flush()
+    {
+        // relative deltas that cancel out are dropped
+        std::erase_if(events,
+                      [](const ::input_event& e)
+                      {
+                          return e.type == EV_REL && e.value == 0;
+                      });
+        if (events.empty()) {
+            clear();
+            return 0;
+        }
+
+        // Uinput only updates its shadow state if the write succeeds, so the frame
+        // can be flushed again after a failure.
+        std::size_t count;
+        try {
+            count = udev->write(std::span<const ::input_event>{events}, true);
+        }
+        catch (...) {
+            reindex();
+            throw;
+        }
+        clear();
+        return count;
+    }
+
+
+    void
+    UinputFrame::reindex()
+        noexcept
+    {
+        abs_index.fill(none);
+        rel_index.fill(none);
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            const auto& e = events[i];
+            if (e.type == EV_ABS && e.code < ABS_CNT && !detail::is_mt_axis(e.code))
+                abs_index[e.code] = i;
+            else if (e.type == EV_REL && e.code < REL_CNT)
+                rel_index[e.code] = i;
+        }
+    }
+
+
+    void
+    UinputFrame::clear()
+        noexcept
+    {
+        events.clear();
+        abs_index.fill(none);
+        rel_index.fill(none);
+        keys_down = udev->get_keys();
+    }
+
+} // namespace evdev
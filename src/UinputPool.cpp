@@ -0,0 +1,268 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <functional>
+#include <string>
+#include <utility>
+
+#include "libevdevxx/UinputPool.hpp"
+
+#include "utils.hpp"
+
+
+namespace evdev {
+
+    std::size_t
+    UinputPool::Hash::operator ()(const DeviceInfo& info)
+        const noexcept
+    {
+        using detail::hash_combine;
+
+        std::size_t result = hash_combine(info.caps.hash(), std::hash<std::string>{}(info.name));
+        if (info.phys)
+            result = hash_combine(result, std::hash<std::string>{}(*info.phys));
+        for (std::uint16_t v : {info.bustype, info.vendor, info.product, info.version})
+            result = hash_combine(result, v);
+        return result;
+    }
+
+
+    bool
+    UinputPool::Equal::operator ()(const DeviceInfo& a,
+                                   const DeviceInfo& b)
+        const noexcept
+    {
+        return a.name == b.name
+            && a.phys == b.phys
+            && a.bustype == b.bustype
+            && a.vendor == b.vendor
+            && a.product == b.product
+            && a.version == b.version
+            && a.caps == b.caps;
+    }
+
+
+    UinputPool::Lease::Lease()
+        noexcept = default;
+
+
+    UinputPool::Lease::Lease(UinputPool* p,
+                             Map::value_type* e,
+                             Uinput&& u)
+        noexcept :
+        pool{p},
+        entry{e},
+        udev{std::move(u)}
+    {}
+
+
+    UinputPool::Lease::~Lease()
+        noexcept
+    {
+        release();
+    }
+
+
+    UinputPool::Lease::Lease(Lease&& other)
+        noexcept :
+        pool{std::exchange(other.pool, nullptr)},
+        entry{std::exchange(other.entry, nullptr)},
+        udev{std::move(other.udev)}
+    {}
+
+
+    UinputPool::Lease&
+    UinputPool::Lease::operator =(Lease&& other)
+        noexcept
+    {
+        if (this != &other) {
+            release();
+            pool = std::exchange(other.pool, nullptr);
+            entry = std::exchange(other.entry, nullptr);
+            udev = std::move(other.udev);
+        }
+        return *this;
+    }
+
+
+    UinputPool::Lease::operator bool()
+        const noexcept
+    {
+        return static_cast<bool>(udev);
+    }
+
+
+    Uinput&
+    UinputPool::Lease::get()
+        noexcept
+    {
+        return udev;
+    }
+
+
+    Uinput&
+    UinputPool::Lease::operator *()
+        noexcept
+    {
+        return udev;
+    }
+
+
+    Uinput*
+    UinputPool::Lease::operator ->()
+        noexcept
+    {
+        return &udev;
+    }
+
+
+    void
+    UinputPool::Lease::release()
+        noexcept
+    {
+        if (pool && udev)
+            pool->give_back(*entry, std::move(udev));
+        pool = nullptr;
+        entry = nullptr;
+        udev.destroy();
+    }
+
+
+    UinputPool::UinputPool(std::size_t max_idle) :
+        max_idle{max_idle}
+    {}
+
+
+    UinputPool::~UinputPool()
+        noexcept = default;
+
+
+    UinputPool::Lease
+    UinputPool::acquire(const Device& dev)
+    {
+        return acquire(DeviceInfo::fingerprint(dev));
+    }
+
+
+    UinputPool::Lease
+    UinputPool::acquire(const DeviceInfo& info)
+    {
+        auto it = idle.find(info);
+        if (it != idle.end() && !it->second.empty()) {
+            ++hits;
+            Uinput udev = std::move(it->second.back());
+            it->second.pop_back();
+            return Lease{this, &*it, std::move(udev)};
+        }
+
+        Uinput udev;
+        udev.create_native(info);
+        ++misses;
+        if (it == idle.end())
+            it = idle.emplace(info.fingerprint(), std::vector<Uinput>{}).first;
+        return Lease{this, &*it, std::move(udev)};
+    }
+
+
+    void
+    UinputPool::give_back(Map::value_type& entry,
+                          Uinput&& udev)
+        noexcept
+    {
+        auto& [info, devices] = entry;
+        if (devices.size() >= max_idle)
+            return;
+
+        try {
+            // The shadow state elides whatever is already neutral.
+            std::vector<::input_event> events;
+            auto add = [&events](std::uint16_t type, std::size_t code, std::int32_t value)
+            {
+                ::input_event& e = events.emplace_back();
+                e.type = type;
+                e.code = code;
+                e.value = value;
+            };
+            for (std::size_t k : udev.get_keys())
+                add(EV_KEY, k, 0);
+            for (std::size_t s : info.caps.get_codes(Type::sw))
+                add(EV_SW, s, 0);
+            const auto& axes = info.caps.get_codes(Type::abs);
+            for (std::size_t a : axes) {
+                if (detail::is_mt_axis(a))
+                    continue;
+                const AbsInfo& abs = info.caps.get_abs_info(Code{static_cast<Code::value_type>(a)});
+                add(EV_ABS, a, abs.min + (abs.max - abs.min) / 2);
+            }
+            // Multitouch state is not tracked, so every slot gets its contact lifted;
+            // the kernel drops the ones already lifted.
+            if (axes.test(ABS_MT_SLOT) && axes.test(ABS_MT_TRACKING_ID)) {
+                const AbsInfo& slots = info.caps.get_abs_info(Code{ABS_MT_SLOT});
+                for (std::int32_t s = slots.min; s <= slots.max; ++s) {
+                    add(EV_ABS, ABS_MT_SLOT, s);
+                    add(EV_ABS, ABS_MT_TRACKING_ID, -1);
+                }
+                add(EV_ABS, ABS_MT_SLOT, slots.min);
+            }
+            udev.write(std::span<const ::input_event>{events}, true);
+            // the next lease starts counting from zero
+            udev.reset_counters();
+
+            devices.push_back(std::move(udev));
+        }
+        catch (...) {
+            // a device that can't be reset is not reused
+        }
+    }
+
+
+    std::uint64_t
+    UinputPool::get_hit_count()
+        const noexcept
+    {
+        return hits;
+    }
+
+
+    std::uint64_t
+    UinputPool::get_miss_count()
+        const noexcept
+    {
+        return misses;
+    }
+
+
+    void
+    UinputPool::reset_counters()
+        noexcept
+    {
+        hits = 0;
+        misses = 0;
+    }
+
+
+    std::size_t
+    UinputPool::get_idle_count()
+        const noexcept
+    {
+        std::size_t count = 0;
+        for (const auto& [info, devices] : idle)
+            count += devices.size();
+        return count;
+    }
+
+
+    void
+    UinputPool::clear()
+        noexcept
+    {
+        // the entries stay, since leases point to them
+        for (auto& [info, devices] : idle)
+            devices.clear();
+    }
+
+} // namespace evdev
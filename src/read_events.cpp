@@ -0,0 +1,48 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cerrno>
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h> // read()
+#endif
+
+#include "read_events.hpp"
+
+
+namespace evdev::detail {
+
+    std::size_t
+    read_events(int fd,
+                std::span<::input_event> events,
+                ReadStatus& status)
+        noexcept
+    {
+        ssize_t r = ::read(fd, events.data(), events.size_bytes());
+        if (r < 0) {
+            status = ReadStatus{-errno};
+            return 0;
+        }
+
+        std::size_t count = r / sizeof(::input_event);
+        status = count ? ReadStatus::success : ReadStatus::again;
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (events[i].type == EV_SYN && events[i].code == SYN_DROPPED) {
+                status = ReadStatus::dropped;
+                break;
+            }
+        }
+
+        return count;
+    }
+
+} // namespace evdev::detail
@@ -0,0 +1,34 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_READ_EVENTS_HPP
+#define LIBEVDEVXX_READ_EVENTS_HPP
+
+#include <cstddef>
+#include <span>
+
+#include <linux/input.h>
+
+#include "libevdevxx/ReadStatus.hpp"
+
+
+// Note: this is an implementation-side header, do not install.
+
+
+namespace evdev::detail {
+
+    // Read events straight from the node, with one system call; `status` reports
+    // `dropped` if any of them is a `SYN_DROPPED`.
+    std::size_t
+    read_events(int fd,
+                std::span<::input_event> events,
+                ReadStatus& status)
+        noexcept;
+
+} // namespace evdev::detail
+
+#endif
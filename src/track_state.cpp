@@ -0,0 +1,31 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "track_state.hpp"
+
+
+namespace evdev::detail {
+
+    void
+    track_state(libevdev* dev,
+                std::span<const ::input_event> events)
+        noexcept
+    {
+        for (const auto& e : events) {
+            switch (e.type) {
+                case EV_ABS:
+                case EV_KEY:
+                case EV_LED:
+                case EV_SW:
+                    // libevdev also tracks the MT slots here
+                    libevdev_set_event_value(dev, e.type, e.code, e.value);
+                    break;
+            }
+        }
+    }
+
+} // namespace evdev::detail
@@ -0,0 +1,29 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBEVDEVXX_TRACK_STATE_HPP
+#define LIBEVDEVXX_TRACK_STATE_HPP
+
+#include <span>
+
+#include <libevdev/libevdev.h>
+
+
+// Note: this is an implementation-side header, do not install.
+
+
+namespace evdev::detail {
+
+    // Update the libevdev state with events that were not read through libevdev.
+    void
+    track_state(libevdev* dev,
+                std::span<const ::input_event> events)
+        noexcept;
+
+} // namespace evdev::detail
+
+#endif
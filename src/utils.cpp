@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <charconv>
 #include <iomanip>
 #include <ios>
 #include <sstream>
@@ -77,4 +78,31 @@ namespace evdev::detail {
         return input;
     }
 
+
+    size_t
+    hash_combine(size_t seed,
+                 size_t h)
+        noexcept
+    {
+        constexpr size_t golden = sizeof(size_t) >= 8
+            ? size_t(0x9e3779b97f4a7c15ull)
+            : size_t(0x9e3779b9);
+        return seed ^ (h + golden + (seed << 6) + (seed >> 2));
+    }
+
+
+    std::optional<unsigned>
+    parse_event_node(std::string_view name)
+        noexcept
+    {
+        if (!name.starts_with("event"))
+            return {};
+        name.remove_prefix(5);
+        unsigned n;
+        auto [end, ec] = std::from_chars(name.data(), name.data() + name.size(), n);
+        if (ec != std::errc{} || end != name.data() + name.size())
+            return {};
+        return n;
+    }
+
 } // namespace evdev::detail
@@ -11,7 +11,11 @@
 #include <functional>
 #include <ios>
 #include <iosfwd>
+#include <optional>
 #include <string>
+#include <string_view>
+
+#include <linux/input-event-codes.h>
 
 
 // Note: this is an implementation-side header, do not install.
@@ -39,6 +43,31 @@ namespace evdev::detail {
             string& line,
             const std::function<bool(char)>& pred);
 
+
+    // Mix `h` into `seed`, like boost::hash_combine(), with the golden ratio constant
+    // for the width of size_t.
+    size_t
+    hash_combine(size_t seed,
+                 size_t h)
+        noexcept;
+
+
+    // The multitouch axes, that depend on the current slot. ABS_MT_TOOL_Y is the last
+    // one; the codes above it are ordinary axes.
+    constexpr
+    bool
+    is_mt_axis(unsigned code)
+        noexcept
+    {
+        return code >= ABS_MT_SLOT && code <= ABS_MT_TOOL_Y;
+    }
+
+
+    // The number N of an `eventN` device node name.
+    std::optional<unsigned>
+    parse_event_node(std::string_view name)
+        noexcept;
+
 } // namespace evdev::detail
 
 #endif
@@ -0,0 +1,203 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+// Compare EventDispatcher against a switch-based router, on a mix of gamepad-like
+// events. Both call the same handlers, so only the routing differs.
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <libevdevxx/EventDispatcher.hpp>
+
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+using evdev::Code;
+using evdev::Event;
+using evdev::Type;
+
+using clock_type = std::chrono::steady_clock;
+
+
+struct Handlers {
+
+    std::array<std::uint64_t, 8> counts{};
+
+    std::array<std::function<void(const Event&)>, 8> fn;
+
+    Handlers()
+    {
+        for (std::size_t i = 0; i < fn.size(); ++i)
+            fn[i] = [this, i](const Event& e) { counts[i] += e.value; };
+    }
+
+};
+
+
+// The kind of code the dispatcher replaces.
+void
+route_switch(const Handlers& h,
+             const Event& e)
+{
+    switch (e.type) {
+        case EV_SYN:
+            if (e.code == SYN_REPORT)
+                h.fn[0](e);
+            break;
+        case EV_KEY:
+            if (e.code >= BTN_SOUTH && e.code <= BTN_THUMBR)
+                h.fn[1](e);
+            else if (e.code >= BTN_DPAD_UP && e.code <= BTN_DPAD_RIGHT)
+                h.fn[2](e);
+            else
+                h.fn[7](e);
+            break;
+        case EV_ABS:
+            switch (e.code) {
+                case ABS_X:
+                case ABS_Y:
+                    h.fn[3](e);
+                    break;
+                case ABS_RX:
+                case ABS_RY:
+                    h.fn[4](e);
+                    break;
+                case ABS_Z:
+                case ABS_RZ:
+                    h.fn[5](e);
+                    break;
+                default:
+                    h.fn[7](e);
+            }
+            break;
+        case EV_MSC:
+            h.fn[6](e);
+            break;
+        default:
+            h.fn[7](e);
+    }
+}
+
+
+void
+setup(evdev::EventDispatcher& d,
+      const Handlers& h)
+{
+    d.set_fallback(h.fn[7]);
+    d.on({Type::syn, Code{SYN_REPORT}}, h.fn[0]);
+    d.on(Type::key, Code{BTN_SOUTH}, Code{BTN_THUMBR}, h.fn[1]);
+    d.on(Type::key, Code{BTN_DPAD_UP}, Code{BTN_DPAD_RIGHT}, h.fn[2]);
+    d.on({Type::abs, Code{ABS_X}}, h.fn[3]);
+    d.on({Type::abs, Code{ABS_Y}}, h.fn[3]);
+    d.on({Type::abs, Code{ABS_RX}}, h.fn[4]);
+    d.on({Type::abs, Code{ABS_RY}}, h.fn[4]);
+    d.on({Type::abs, Code{ABS_Z}}, h.fn[5]);
+    d.on({Type::abs, Code{ABS_RZ}}, h.fn[5]);
+    d.on(Type::msc, h.fn[6]);
+}
+
+
+std::vector<Event>
+make_events(std::size_t count)
+{
+    std::mt19937 rng{42};
+    const std::array<std::pair<std::uint16_t, std::uint16_t>, 14> pool{{
+        {EV_SYN, SYN_REPORT},
+        {EV_SYN, SYN_REPORT},
+        {EV_ABS, ABS_X},
+        {EV_ABS, ABS_Y},
+        {EV_ABS, ABS_RX},
+        {EV_ABS, ABS_RY},
+        {EV_ABS, ABS_Z},
+        {EV_ABS, ABS_RZ},
+        {EV_ABS, ABS_HAT0X},
+        {EV_KEY, BTN_SOUTH},
+        {EV_KEY, BTN_TR},
+        {EV_KEY, BTN_DPAD_UP},
+        {EV_KEY, KEY_A},
+        {EV_MSC, MSC_SCAN},
+    }};
+    std::uniform_int_distribution<std::size_t> pick{0, pool.size() - 1};
+
+    std::vector<Event> events(count);
+    for (auto& e : events) {
+        auto [type, code] = pool[pick(rng)];
+        e.type = Type{type};
+        e.code = Code{code};
+        e.value = 1;
+    }
+    return events;
+}
+
+
+template<typename F>
+double
+measure(const std::vector<Event>& events,
+        unsigned passes,
+        F route)
+{
+    auto start = clock_type::now();
+    for (unsigned p = 0; p < passes; ++p)
+        for (const Event& e : events)
+            route(e);
+    std::chrono::duration<double, std::nano> elapsed = clock_type::now() - start;
+    return elapsed.count() / (double(events.size()) * passes);
+}
+
+
+int
+main(int argc,
+     char* argv[])
+{
+    std::size_t count = 100'000;
+    unsigned passes = 100;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 < argc && arg == "--events")
+            count = std::stoul(argv[++i]);
+        else if (i + 1 < argc && arg == "--passes")
+            passes = std::stoul(argv[++i]);
+        else {
+            cerr << "Usage: " << argv[0] << " [--events N] [--passes N]" << endl;
+            return -1;
+        }
+    }
+
+    const auto events = make_events(count);
+
+    Handlers by_switch;
+    double ns_switch = measure(events, passes,
+                               [&by_switch](const Event& e) { route_switch(by_switch, e); });
+
+    Handlers by_table;
+    evdev::EventDispatcher dispatcher;
+    setup(dispatcher, by_table);
+    double ns_table = measure(events, passes,
+                              [&dispatcher](const Event& e) { dispatcher.dispatch(e); });
+
+    if (by_switch.counts != by_table.counts) {
+        cerr << "Error: the routers disagree." << endl;
+        return -1;
+    }
+
+    cout << count << " events, " << passes << " passes\n\n"
+         << std::fixed << std::setprecision(2)
+         << std::left << std::setw(16) << "switch" << std::right
+         << std::setw(10) << ns_switch << " ns/event\n"
+         << std::left << std::setw(16) << "EventDispatcher" << std::right
+         << std::setw(10) << ns_table << " ns/event" << endl;
+}
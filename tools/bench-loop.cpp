@@ -0,0 +1,196 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+// Compare the EventLoop backends, on uinput loopback devices: events are written to
+// virtual devices, and read back through the loop. The read system calls are taken
+// from /proc/self/io; with io_uring, the reads don't go through read(), and only the
+// waits are left.
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <libevdevxx/Device.hpp>
+#include <libevdevxx/EventLoop.hpp>
+#include <libevdevxx/Uinput.hpp>
+
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+using evdev::EventLoop;
+
+using namespace std::literals;
+
+
+struct Options {
+    unsigned devices = 16;
+    unsigned rounds = 2000;
+    unsigned burst = 8; // frames per device, per round
+};
+
+
+struct Result {
+    std::uint64_t events = 0;
+    std::uint64_t waits = 0;
+    std::uint64_t reads = 0;
+    std::chrono::nanoseconds elapsed{};
+};
+
+
+// How many read-like system calls this process made.
+std::uint64_t
+read_syscalls()
+{
+    std::ifstream io{"/proc/self/io"};
+    std::string key;
+    std::uint64_t val;
+    while (io >> key >> val)
+        if (key == "syscr:")
+            return val;
+    return 0;
+}
+
+
+Result
+run(EventLoop::Backend backend,
+    std::vector<evdev::Device>& devs,
+    std::vector<evdev::Uinput>& udevs,
+    const Options& opt)
+{
+    EventLoop loop{backend};
+
+    std::uint64_t received = 0;
+    for (auto& dev : devs)
+        loop.add(dev,
+                 [&received](evdev::Device&, std::span<const evdev::Event> events)
+                 {
+                     received += events.size();
+                 });
+
+    ::input_event motion{};
+    motion.type = EV_REL;
+    motion.code = REL_X;
+    motion.value = 1;
+
+    Result result;
+    std::uint64_t expected = 0;
+    const auto reads_before = read_syscalls();
+    const auto start = std::chrono::steady_clock::now();
+
+    for (unsigned r = 0; r < opt.rounds; ++r) {
+        // bursts are small enough to never overflow the kernel's buffers
+        for (auto& udev : udevs)
+            for (unsigned b = 0; b < opt.burst; ++b)
+                udev.write(std::span{&motion, 1}, true);
+        expected += 2ull * udevs.size() * opt.burst;
+
+        while (received < expected) {
+            ++result.waits;
+            if (!loop.run_once(1s))
+                throw std::runtime_error{"timed out waiting for events"};
+        }
+    }
+
+    result.elapsed = std::chrono::steady_clock::now() - start;
+    result.reads = read_syscalls() - reads_before;
+    result.events = received;
+
+    for (auto& dev : devs)
+        loop.remove(dev);
+    return result;
+}
+
+
+void
+report(std::string_view name,
+       const Result& r)
+{
+    double n = r.events;
+    cout << std::left << std::setw(10) << name << std::right
+         << std::setw(12) << r.events
+         << std::fixed << std::setprecision(4)
+         << std::setw(12) << r.waits / n
+         << std::setw(12) << r.reads / n
+         << std::setw(12) << (r.waits + r.reads) / n
+         << std::setprecision(1)
+         << std::setw(12) << r.elapsed.count() / n
+         << endl;
+}
+
+
+int
+main(int argc,
+     char* argv[])
+{
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 < argc && arg == "--devices")
+            opt.devices = std::stoul(argv[++i]);
+        else if (i + 1 < argc && arg == "--rounds")
+            opt.rounds = std::stoul(argv[++i]);
+        else if (i + 1 < argc && arg == "--burst")
+            opt.burst = std::stoul(argv[++i]);
+        else {
+            cerr << "Usage: " << argv[0]
+                 << " [--devices N] [--rounds N] [--burst N]" << endl;
+            return -1;
+        }
+    }
+
+    try {
+        evdev::Device proto;
+        proto.set_name("evdevxx bench");
+        proto.enable_rel(evdev::Code{REL_X});
+        proto.enable_rel(evdev::Code{REL_Y});
+        proto.enable_key(evdev::Code{BTN_LEFT});
+
+        std::vector<evdev::Uinput> udevs(opt.devices);
+        std::vector<const evdev::Uinput*> pending;
+        for (auto& udev : udevs) {
+            udev.create_native(proto);
+            pending.push_back(&udev);
+        }
+        if (!evdev::Uinput::wait_ready(pending, 5s))
+            throw std::runtime_error{"uinput devices did not become ready"};
+
+        std::vector<evdev::Device> devs;
+        for (auto& udev : udevs)
+            devs.emplace_back(udev.get_devnode());
+
+        cout << opt.devices << " devices, "
+             << opt.rounds << " rounds of "
+             << opt.burst << " frames per device\n\n"
+             << std::left << std::setw(10) << "backend" << std::right
+             << std::setw(12) << "events"
+             << std::setw(12) << "waits/ev"
+             << std::setw(12) << "reads/ev"
+             << std::setw(12) << "sysc/ev"
+             << std::setw(12) << "ns/ev"
+             << endl;
+
+        report("epoll", run(EventLoop::Backend::epoll, devs, udevs, opt));
+        if (EventLoop::is_supported(EventLoop::Backend::io_uring))
+            report("io_uring", run(EventLoop::Backend::io_uring, devs, udevs, opt));
+        else
+            cout << "io_uring: not available" << endl;
+    }
+    catch (std::exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return -1;
+    }
+}
@@ -0,0 +1,212 @@
+/*
+ * libevdevxx - a C++ wrapper for libevdev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: MIT
+ */
+
+// Compare EventQueue against a mutex-protected std::deque<Event>, for throughput (a
+// producer thread pushing batches) and latency (one event bounced between two threads).
+// Waiting threads yield, so the numbers are meaningful on a single CPU too.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <libevdevxx/EventQueue.hpp>
+
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+using evdev::Event;
+
+using clock_type = std::chrono::steady_clock;
+
+
+constexpr std::size_t capacity = 4096;
+
+
+// The handoff this is meant to replace; bounded like the EventQueue.
+class MutexQueue {
+
+    std::mutex mutex;
+    std::deque<Event> events;
+
+public:
+
+    std::size_t
+    push(std::span<const Event> values)
+    {
+        std::lock_guard guard{mutex};
+        std::size_t n = std::min(values.size(), capacity - events.size());
+        events.insert(events.end(), values.begin(), values.begin() + n);
+        return n;
+    }
+
+
+    std::size_t
+    pop(std::span<Event> out)
+    {
+        std::lock_guard guard{mutex};
+        std::size_t n = std::min(out.size(), events.size());
+        std::copy_n(events.begin(), n, out.begin());
+        events.erase(events.begin(), events.begin() + n);
+        return n;
+    }
+
+};
+
+
+struct SpscQueue {
+
+    evdev::EventQueue<Event> queue{capacity};
+
+    std::size_t
+    push(std::span<const Event> values)
+    {
+        return queue.push(values);
+    }
+
+    std::size_t
+    pop(std::span<Event> out)
+    {
+        return queue.pop(out);
+    }
+
+};
+
+
+// Events per second, with a producer pushing batches of `batch` events.
+template<typename Q>
+double
+throughput(std::uint64_t total,
+           std::size_t batch)
+{
+    Q q;
+    std::array<Event, 256> in{};
+    batch = std::min(batch, in.size());
+
+    auto start = clock_type::now();
+
+    std::jthread producer{
+        [&q, &in, total, batch]
+        {
+            std::uint64_t sent = 0;
+            while (sent < total) {
+                std::size_t n = std::min<std::uint64_t>(batch, total - sent);
+                std::span<const Event> rest{in.data(), n};
+                while (!rest.empty())
+                    if (std::size_t pushed = q.push(rest))
+                        rest = rest.subspan(pushed);
+                    else
+                        std::this_thread::yield();
+                sent += n;
+            }
+        }
+    };
+
+    std::array<Event, 256> out;
+    std::uint64_t received = 0;
+    while (received < total)
+        if (std::size_t n = q.pop(out))
+            received += n;
+        else
+            std::this_thread::yield();
+
+    std::chrono::duration<double> elapsed = clock_type::now() - start;
+    return total / elapsed.count();
+}
+
+
+// Average one-way latency, in nanoseconds, of an event bounced back and forth.
+template<typename Q>
+double
+latency(unsigned rounds)
+{
+    Q ping;
+    Q pong;
+
+    std::jthread echo{
+        [&ping, &pong, rounds]
+        {
+            Event e;
+            for (unsigned i = 0; i < rounds; ++i) {
+                while (!ping.pop({&e, 1}))
+                    std::this_thread::yield();
+                pong.push({&e, 1});
+            }
+        }
+    };
+
+    Event e;
+    auto start = clock_type::now();
+    for (unsigned i = 0; i < rounds; ++i) {
+        ping.push({&e, 1});
+        while (!pong.pop({&e, 1}))
+            std::this_thread::yield();
+    }
+    std::chrono::duration<double, std::nano> elapsed = clock_type::now() - start;
+    return elapsed.count() / rounds / 2;
+}
+
+
+void
+report(std::string_view name,
+       double events_per_sec,
+       double ns)
+{
+    cout << std::left << std::setw(12) << name << std::right
+         << std::fixed << std::setprecision(1)
+         << std::setw(16) << events_per_sec / 1e6
+         << std::setw(16) << ns
+         << endl;
+}
+
+
+int
+main(int argc,
+     char* argv[])
+{
+    std::uint64_t total = 20'000'000;
+    std::size_t batch = 64;
+    unsigned rounds = 200'000;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 < argc && arg == "--events")
+            total = std::stoull(argv[++i]);
+        else if (i + 1 < argc && arg == "--batch")
+            batch = std::stoul(argv[++i]);
+        else if (i + 1 < argc && arg == "--rounds")
+            rounds = std::stoul(argv[++i]);
+        else {
+            cerr << "Usage: " << argv[0]
+                 << " [--events N] [--batch N] [--rounds N]" << endl;
+            return -1;
+        }
+    }
+
+    cout << total << " events in batches of " << batch << ", "
+         << rounds << " latency rounds\n\n"
+         << std::left << std::setw(12) << "queue" << std::right
+         << std::setw(16) << "Mevents/s"
+         << std::setw(16) << "latency (ns)"
+         << endl;
+
+    report("mutex",
+           throughput<MutexQueue>(total, batch),
+           latency<MutexQueue>(rounds));
+    report("EventQueue",
+           throughput<SpscQueue>(total, batch),
+           latency<SpscQueue>(rounds));
+}
@@ -10,7 +10,10 @@
 #include <iostream>
 #include <iomanip>
 #include <exception>
+#include <filesystem>
 #include <optional>
+#include <string_view>
+#include <vector>
 
 #include <fcntl.h>
 #include <sys/ioctl.h>
@@ -31,7 +34,8 @@ using std::setfill;
 using std::setw;
 using std::string;
 
-using evdev::Device;
+using evdev::Capabilities;
+using evdev::DeviceInfo;
 using evdev::Property;
 using evdev::Type;
 using evdev::Code;
@@ -51,71 +55,75 @@ print_if(const string& label,
 
 
 void
-print_codes(const Device& d,
-                 Type t)
+print_codes(const Capabilities& caps,
+            Type t)
 {
-    auto codes = d.get_codes(t);
+    const auto& codes = caps.get_codes(t);
     unsigned x = 4;
     cout << "   ";
 
-    for (size_t i = 0; i < codes.size(); ++i) {
-        auto c = codes[i];
-        string name = code_to_string(t, c);
+    bool first = true;
+    for (size_t c : codes) {
+        string name = code_to_string(t, Code(c));
 
-        if (i > 0 && name.size() + x + 2 > columns) {
-            cout << "\n   ";
-            x = 3;
-        }
-        cout << " " << name;
-        x += name.size() + 1;
-        if (i+1 < codes.size()) {
+        if (!first) {
             cout << ",";
             ++x;
+            if (name.size() + x + 2 > columns) {
+                cout << "\n   ";
+                x = 3;
+            }
         }
+        first = false;
+        cout << " " << name;
+        x += name.size() + 1;
     }
     cout << endl;
 }
 
 
 void
-print_abs(const Device& d)
+print_abs(const Capabilities& caps)
 {
-    auto codes = d.get_codes(Type::abs);
-    for (Code c : codes) {
-        cout << "    " << code_to_string(Type::abs, c) << "\n";
-        cout << "        " << d.get_abs_info(c) << "\n";
+    for (size_t c : caps.get_codes(Type::abs)) {
+        Code code(c);
+        cout << "    " << code_to_string(Type::abs, code) << "\n";
+        cout << "        " << caps.get_abs_info(code) << "\n";
     }
 }
 
 
 void
-print_device(const Device& d)
+print_device(const DeviceInfo& d)
 {
-    cout << "  Name: " << d.get_name() << "\n";
-    print_if("  Phys: ", d.get_phys());
-    print_if("  Uniq: ", d.get_uniq());
+    cout << "  Name: " << d.name << "\n";
+    print_if("  Phys: ", d.phys);
+    print_if("  Uniq: ", d.uniq);
 
     cout << hex << setfill('0')
-         << "  VID: " << setw(4) << d.get_vendor() << "\n"
-         << "  PID: " << setw(4) << d.get_product() << "\n"
-         << "  BUS: " << setw(4) << d.get_bustype() << "\n"
-         << "  VER: " << setw(4) << d.get_version() << "\n"
-         << "  DRV: " << setw(4) << d.get_driver_version() << "\n"
+         << "  VID: " << setw(4) << d.vendor << "\n"
+         << "  PID: " << setw(4) << d.product << "\n"
+         << "  BUS: " << setw(4) << d.bustype << "\n"
+         << "  VER: " << setw(4) << d.version << "\n"
+         << "  DRV: " << setw(4) << d.driver_version << "\n"
          << dec;
 
-    for (auto prop : d.get_properties())
-        cout << "  Prop: " << prop << "\n";
+    const Capabilities& caps = d.caps;
 
-    for (auto t : d.get_types()) {
+    for (size_t p : caps.get_properties())
+        cout << "  Prop: " << Property(p) << "\n";
+
+    for (size_t i : caps.get_types()) {
+        Type t(i);
         cout << "  Type: " << t << "\n";
         switch (t) {
             case Type::abs:
-                print_abs(d);
+                print_abs(caps);
                 break;
             case Type::syn:
                 break;
             default:
-                print_codes(d, t);
+                print_codes(caps, t);
         }
     }
 
@@ -140,14 +148,33 @@ main(int argc,
 {
     read_columns_env();
 
-    for (int i = 1; i < argc; ++i) {
+    int first = 1;
+    optional<evdev::CapabilityCache> cache;
+    if (argc > 2 && std::string_view{argv[1]} == "--cache") {
+        cache.emplace(argv[2]);
+        first = 3;
+    }
+
+    // probe all devices in parallel; a hung device times out without blocking the others
+    std::vector<std::filesystem::path> paths{argv + first, argv + argc};
+    evdev::DeviceScanner scanner;
+    auto infos = cache ? scanner.scan(paths, *cache) : scanner.scan(paths);
+
+    for (size_t i = 0; i < infos.size(); ++i) {
+        cout << "Device #" << i + 1 << ": "
+             << infos[i].path.string() << endl;
+        if (infos[i])
+            print_device(infos[i]);
+        else
+            cerr << "Error: " << infos[i].error.message() << endl;
+    }
+
+    if (cache) {
         try {
-            cout << "Device #" << i << ": "
-                 << argv[i] << endl;
-            print_device(Device{argv[i]});
+            cache->save();
         }
         catch (std::exception& e) {
-            cerr << "Error: " << e.what() << endl;
+            cerr << "Error: could not save the cache: " << e.what() << endl;
         }
     }
 }
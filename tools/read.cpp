@@ -6,15 +6,17 @@
  */
 
 
-#include <chrono>
+#include <algorithm>
 #include <csignal>
 #include <exception>
 #include <iostream>
-#include <signal.h>
-#include <thread>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <libevdevxx/Device.hpp>
-#include <libevdevxx/SyncError.hpp>
+#include <libevdevxx/EventLoop.hpp>
 
 
 using std::cerr;
@@ -22,16 +24,91 @@ using std::cout;
 using std::endl;
 using std::flush;
 
-using namespace std::literals;
 
-volatile std::sig_atomic_t should_quit = false;
+// Event types and codes listed in a --only or --except option.
+struct Selection {
+    std::vector<evdev::Type> types;
+    std::vector<evdev::TypeCode> codes;
+};
 
 
-extern "C"
+// Parse a comma-separated list of names, like "EV_KEY,REL_X".
+Selection
+parse_selection(std::string_view list)
+{
+    Selection result;
+    while (!list.empty()) {
+        auto comma = list.find(',');
+        std::string_view name = list.substr(0, comma);
+        list = comma == list.npos ? "" : list.substr(comma + 1);
+        if (name.starts_with("EV_"))
+            result.types.push_back(evdev::Type::parse(name));
+        else {
+            auto [type, code] = evdev::Code::parse(name);
+            result.codes.push_back({type, code});
+        }
+    }
+    return result;
+}
+
+
+bool
+contains(const std::vector<evdev::Type>& types,
+         evdev::Type t)
+{
+    return std::ranges::find(types, t) != types.end();
+}
+
+
+// Mask everything not selected.
 void
-handle_terminate(int)
+apply_only(evdev::Device& dev,
+           const Selection& sel)
 {
-    should_quit = true;
+    std::vector<evdev::Type> types = sel.types;
+    for (auto& tc : sel.codes)
+        if (!contains(types, tc.type))
+            types.push_back(tc.type);
+    dev.set_type_mask(types);
+
+    for (evdev::Type t : types) {
+        if (t == evdev::Type::syn || contains(sel.types, t))
+            continue;
+        std::vector<evdev::Code> codes;
+        for (auto& tc : sel.codes)
+            if (tc.type == t)
+                codes.push_back(tc.code);
+        dev.set_event_mask(t, codes);
+    }
+}
+
+
+// Mask everything selected.
+void
+apply_except(evdev::Device& dev,
+             const Selection& sel)
+{
+    std::vector<evdev::Type> types;
+    for (evdev::Type t : dev.get_types())
+        if (!contains(sel.types, t))
+            types.push_back(t);
+    dev.set_type_mask(types);
+
+    for (evdev::Type t : types) {
+        if (t == evdev::Type::syn)
+            continue;
+        auto excluded = [&sel, t](evdev::Code c)
+        {
+            return std::ranges::any_of(sel.codes,
+                                       [t, c](const evdev::TypeCode& tc)
+                                       {
+                                           return tc.type == t && tc.code == c;
+                                       });
+        };
+        std::vector<evdev::Code> codes = dev.get_codes(t);
+        if (std::erase_if(codes, excluded))
+            dev.set_event_mask(t, codes);
+    }
 }
 
 
@@ -39,40 +116,73 @@ int
 main(int argc,
      char* argv[])
 {
-    if (argc != 2) {
+    std::string_view only;
+    std::string_view except;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--only" && i + 1 < argc)
+            only = argv[++i];
+        else if (arg == "--except" && i + 1 < argc)
+            except = argv[++i];
+        else if (!path && !arg.starts_with("-"))
+            path = argv[i];
+        else {
+            path = nullptr;
+            break;
+        }
+    }
+
+    if (!path || (!only.empty() && !except.empty())) {
         cerr << "Usage:\n"
-             << "        dump-events <DEVICE>\n"
-             << "<DEVICE> is any of /dev/input/event*" << endl;
+             << "        evdevxx-read [--only <LIST> | --except <LIST>] <DEVICE>\n"
+             << "<DEVICE> is any of /dev/input/event*\n"
+             << "<LIST> is a comma-separated list of types and codes, like EV_KEY,REL_X;\n"
+             << "       they're filtered by the kernel, through EVIOCSMASK." << endl;
         return -1;
     }
 
     try {
-        evdev::Device dev{argv[1]};
+        evdev::Device dev{path};
         cout << "Opened device \"" << dev.get_name() << "\"" << endl;
 
-        std::signal(SIGINT, handle_terminate);
-        std::signal(SIGTERM, handle_terminate);
-
-        while (!should_quit) {
-
-            try {
-                while (!should_quit && !dev.has_pending())
-                    std::this_thread::sleep_for(10ms);
-                if (should_quit)
-                    break;
-
-                auto event = dev.read();
-                cout << event << endl;
-            }
-            catch (evdev::SyncError& se) {
-                cout << "lost sync" << endl;
-                // trigger a resync
-                evdev::Event delta;
-                while (dev.read(delta, evdev::ReadFlag::resync) == evdev::ReadStatus::dropped)
-                    cout << "delta: " << delta << endl;
-                cout << "sync restored" << endl;
-            }
-        }
+        if (!only.empty())
+            apply_only(dev, parse_selection(only));
+        if (!except.empty())
+            apply_except(dev, parse_selection(except));
+
+        evdev::EventLoop loop;
+
+        auto quit = [&loop](int) { loop.stop(); };
+        loop.add_signal(SIGINT, quit);
+        loop.add_signal(SIGTERM, quit);
+
+        bool resyncing = false;
+        loop.add(dev,
+                 [&resyncing](evdev::Device&,
+                              std::span<const evdev::Event> events)
+                 {
+                     for (auto& event : events) {
+                         if (event.type == evdev::Type::syn
+                             && event.code == SYN_DROPPED) {
+                             cout << "lost sync" << "\n";
+                             resyncing = true;
+                             continue;
+                         }
+                         if (resyncing)
+                             cout << "delta: ";
+                         cout << event << "\n";
+                         if (resyncing
+                             && event.type == evdev::Type::syn
+                             && event.code == SYN_REPORT) {
+                             cout << "sync restored" << "\n";
+                             resyncing = false;
+                         }
+                     }
+                     cout << flush;
+                 });
+
+        loop.run();
 
         cout << "\nExiting." << endl;
     }